@@ -3,65 +3,507 @@
 #define TINYSTL_ALLOC_H
 
 #include<cstdlib>
+#include<cstdint>
+#include<cstring>
 #include<iostream>
+#include<mutex>
+#include<atomic>
+#include<new>
+#include<thread>
+#include<chrono>
+#include<condition_variable>
+#include<vector>
+#include<utility>
+#ifdef _WIN32
+#include<malloc.h>
+#else
+#include<sys/mman.h>
+#endif
+
+//Ϊ0ʱر̻߳棬ֱ߼ڴ
+#ifndef TINYSTL_ALLOC_THREAD_CACHE
+#define TINYSTL_ALLOC_THREAD_CACHE 1
+#endif
+
+//Ϊ1ʱۼƸsize classͳƼΪ0ʱ뱻ȫ
+#ifndef TINYSTL_ALLOC_STATS
+#define TINYSTL_ALLOC_STATS 0
+#endif
+#if TINYSTL_ALLOC_STATS
+#define TINYSTL_ALLOC_STAT(...) __VA_ARGS__
+#else
+#define TINYSTL_ALLOC_STAT(...)
+#endif
+
+//̻߳ÿrefillȡصֽÿsize classڴӦ
+#ifndef TINYSTL_ALLOC_MAX_BATCH
+#define TINYSTL_ALLOC_MAX_BATCH 64
+#endif
+#ifndef TINYSTL_ALLOC_MAX_BATCH_BYTES
+#define TINYSTL_ALLOC_MAX_BATCH_BYTES (32 * 1024)
+#endif
+
+//ڴظ飬ֱӽmalloc
+#ifndef TINYSTL_ALLOC_MAX_BYTES
+#define TINYSTL_ALLOC_MAX_BYTES 32768
+#endif
+//128ֽsize class֮ٷֱ
+#ifndef TINYSTL_ALLOC_CLASS_GROWTH
+#define TINYSTL_ALLOC_CLASS_GROWTH 125
+#endif
+
 namespace Tiny_STL {
 
+	// size class
+	// 128ֽʱ8ֽڵ֮TINYSTL_ALLOC_CLASS_GROWTHֱTINYSTL_ALLOC_MAX_BYTES
+	// 1024ֽڵsize class16ı֮128ıʹβұܾȷ
+	class size_class_config {
+	public:
+		enum ESizes {
+			Align = 8, Step_max = 128, Small_max = 1024, Large_align = 128,
+			Max_bytes = TINYSTL_ALLOC_MAX_BYTES, Growth = TINYSTL_ALLOC_CLASS_GROWTH
+		};
+		//Small_maxڲұеƫƣʹβұβ
+		enum ELookup {
+			Large_offset = Small_max / Align - Small_max / Large_align,
+			Lookup_num = (Max_bytes > Small_max ?
+				(Max_bytes + Large_align - 1) / Large_align + Large_offset : Max_bytes / Align) + 1
+		};
+		static_assert(Max_bytes >= Step_max && Max_bytes % (Max_bytes > Small_max ? 128 : (Max_bytes > Step_max ? 16 : 8)) == 0,
+			"TINYSTL_ALLOC_MAX_BYTES must be a multiple of its size class alignment");
+		static_assert(Growth > 100, "TINYSTL_ALLOC_CLASS_GROWTH must be greater than 100");
+
+		static constexpr size_t round_up(size_t bytes, size_t align) {
+			return (bytes + align - 1) & ~(align - 1);
+		}
+		//size֮һsize class
+		static constexpr size_t next_size(size_t size) {
+			if (size < Step_max)
+				return size + Align;
+			size_t next = size * Growth / 100;
+			next = next > Small_max ? round_up(next, Large_align) : round_up(next, 16);
+			return next < static_cast<size_t>(Max_bytes) ? next : static_cast<size_t>(Max_bytes);
+		}
+		static constexpr size_t count_classes(size_t size = Align, size_t n = 1) {
+			return size >= Max_bytes ? n : count_classes(next_size(size), n + 1);
+		}
+	};
+
+	//ɵsize classСֽsize classĲұ
+	template<size_t ClassNum, size_t LookupNum>
+	struct size_class_table {
+		size_t class_size[ClassNum];
+		unsigned char class_index[LookupNum];
+		constexpr size_class_table() :class_size(), class_index() {
+			size_t size = size_class_config::Align;
+			for (size_t i = 0; i < ClassNum; ++i) {
+				class_size[i] = size;
+				size = size_class_config::next_size(size);
+			}
+			size_t c = 0;
+			for (size_t j = 0; j < LookupNum; ++j) {
+				//ұjǵֽ
+				size_t max_bytes = j <= size_class_config::Small_max / size_class_config::Align ? j * size_class_config::Align :
+					(j - size_class_config::Large_offset) * size_class_config::Large_align;
+				while (c + 1 < ClassNum && class_size[c] < max_bytes)
+					++c;
+				class_index[j] = static_cast<unsigned char>(c);
+			}
+		}
+	};
+
+	// size classԼֽsize classĲ
+	class size_class_map :public size_class_config {
+	public:
+		enum ENClasses { Class_num = size_class_config::count_classes() };
+		//鰴Ȼзʱֵ
+		enum EAlign { Max_align = 4096 };
+		static_assert(Class_num <= 256, "too many size classes");
+		typedef size_class_table<Class_num, size_class_config::Lookup_num> table_type;
+		static constexpr table_type table = table_type();
+
+		//޷֧bytessize classbytesܳMax_bytes
+		static size_t class_of(size_t bytes) {
+			size_t small = (bytes + Align - 1) / Align;
+			size_t large = (bytes + Large_align - 1) / Large_align + Large_offset;
+			size_t mask = 0 - static_cast<size_t>(bytes > Small_max);
+			return table.class_index[small ^ ((small ^ large) & mask)];
+		}
+		static size_t class_size(size_t index) {
+			return table.class_size[index];
+		}
+		//bytessize classbytesСAlign
+		static size_t floor_class(size_t bytes) {
+			size_t index = class_of(bytes);
+			return table.class_size[index] > bytes ? index - 1 : index;
+		}
+		//size classȻ룺С2ݣMax_align
+		//64ֽڵλ64ֽڱ߽ϣ48ֽڵλ16ֽڱ߽
+		static size_t class_align(size_t index) {
+			size_t size = table.class_size[index];
+			size_t align = size & (0 - size);
+			return align < static_cast<size_t>(Max_align) ? align : static_cast<size_t>(Max_align);
+		}
+		//ܰalignmentbytesֽڵsize class˷ѳһûкʵsize classʱClass_num
+		static size_t aligned_class(size_t bytes, size_t alignment) {
+			size_t need = round_up(bytes ? bytes : 1, alignment);
+			if (need > static_cast<size_t>(Max_bytes))
+				return Class_num;
+			size_t index = class_of(need);
+			while (index < Class_num && class_align(index) < alignment)
+				++index;
+			if (index == Class_num || table.class_size[index] > 2 * need)
+				return Class_num;
+			return index;
+		}
+	};
+	constexpr size_class_map::table_type size_class_map::table;
+
+	// spanԴallocͨϵͳ͹黹span
+	// allocateذbytesbytesֽڴ棬bytes2ݣʵֱ̰߳ȫ
+	class chunk_provider {
+	public:
+		virtual ~chunk_provider() { }
+		virtual void *allocate(size_t bytes) = 0;
+		virtual void deallocate(void *ptr, size_t bytes) = 0;
+	};
+
+	// ĬϵԴmalloc
+	class malloc_chunk_provider :public chunk_provider {
+	public:
+		void *allocate(size_t bytes) override {
+#ifdef _WIN32
+			return _aligned_malloc(bytes, bytes);
+#else
+			void *ptr = nullptr;
+			return posix_memalign(&ptr, bytes, bytes) == 0 ? ptr : nullptr;
+#endif
+		}
+		//Ĵڴfree֮δػϵͳmadviseҳ
+		void deallocate(void *ptr, size_t bytes) override {
+#ifdef _WIN32
+			(void)bytes;
+			_aligned_free(ptr);
+#else
+#ifdef MADV_DONTNEED
+			madvise(ptr, bytes, MADV_DONTNEED);
+#else
+			(void)bytes;
+#endif
+			free(ptr);
+#endif
+		}
+	};
+
+#ifndef _WIN32
+	// mmapԤregion_bytes(Ĭ2MB)Ĵ򲢱MADV_HUGEPAGEٴзspan
+	// ʹСҳϣTLBȱʧ
+	// 黹spanֻMADV_DONTNEEDҳַ֮븴
+	class mmap_chunk_provider :public chunk_provider {
+	public:
+		explicit mmap_chunk_provider(size_t region_bytes = 2 * 1024 * 1024)
+			:region(region_bytes), cur(nullptr), end(nullptr) { }
+		void *allocate(size_t bytes) override {
+			std::lock_guard<std::mutex> lock(mutex);
+			for (size_t i = 0; i < free_chunks.size(); ++i) {
+				if (free_chunks[i].second == bytes) {
+					void *ptr = free_chunks[i].first;
+					free_chunks[i] = free_chunks.back();
+					free_chunks.pop_back();
+					return ptr;
+				}
+			}
+			if (bytes > region)
+				return map_aligned(bytes);
+			char *ptr = align_up(cur, bytes);
+			if (!cur || ptr + bytes > end) {
+				cur = static_cast<char *>(map_aligned(region));
+				if (!cur) {
+					end = nullptr;
+					return nullptr;
+				}
+				end = cur + region;
+				ptr = cur;
+			}
+			cur = ptr + bytes;
+			return ptr;
+		}
+		void deallocate(void *ptr, size_t bytes) override {
+#ifdef MADV_DONTNEED
+			madvise(ptr, bytes, MADV_DONTNEED);
+#endif
+			std::lock_guard<std::mutex> lock(mutex);
+			free_chunks.push_back(std::make_pair(ptr, bytes));
+		}
+	private:
+		static char *align_up(char *p, size_t alignment) {
+			return reinterpret_cast<char *>((reinterpret_cast<uintptr_t>(p) + alignment - 1) & ~static_cast<uintptr_t>(alignment - 1));
+		}
+		//ӳһֵĳȣٰβĲֽӳ
+		static void *map_aligned(size_t bytes) {
+			size_t length = bytes * 2;
+#ifdef MAP_ANONYMOUS
+			void *raw = mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+#else
+			void *raw = mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANON, -1, 0);
+#endif
+			if (raw == MAP_FAILED)
+				return nullptr;
+			char *begin = static_cast<char *>(raw);
+			char *aligned = align_up(begin, bytes);
+			if (aligned != begin)
+				munmap(begin, aligned - begin);
+			if (begin + length != aligned + bytes)
+				munmap(aligned + bytes, begin + length - (aligned + bytes));
+#ifdef MADV_HUGEPAGE
+			madvise(aligned, bytes, MADV_HUGEPAGE);
+#endif
+			return aligned;
+		}
+
+		size_t region;
+		char *cur;//ǰδзֵĲ
+		char *end;
+		std::mutex mutex;
+		std::vector<std::pair<void *, size_t>> free_chunks;
+	};
+#endif
+
 	 // ռڴֽΪλ
+	 // ÿ̳߳˽еfree-lists棬յĿ·
+	 // ̻߳ڴ֮䰴ת飬ڴɻ
+	 // СӰSpan_bytesspanз֣spanͷ¼з̻߳(owner)
+	 // ߳ͷŵͨCASҵownerremote-freeϣowner´refillʱջ
+	 // spanǼڴУtrim()ȫ鶼ѿеspan黹ϵͳ
 
 	class alloc {
 	private:
 		//ͬڴϵС
-		enum EAligns
-		{
-			EAlign128 = 8, EAlign256 = 16, EAlign512 = 32,
-			EAlign1K = 64, EAlign2K = 128
-		};
-		enum ENFreeLists { Free_list_num = EAligns::EAlign2K / EAligns::EAlign128 };//free-listsĸ
-		enum ENObjs { NOBJS = 20 };//ÿӵĽڵ
+		enum EAligns { Max_bytes = size_class_map::Max_bytes };
+		enum ENFreeLists { Free_list_num = size_class_map::Class_num };//free-listsĸ
+		//̻߳ÿfree-listౣֽ
+		enum ECache { Cache_max_bytes = 64 * 1024, Cache_max_objs = 256 };
+		//refillε
+		enum EBatch { Max_batch = TINYSTL_ALLOC_MAX_BATCH, Max_batch_bytes = TINYSTL_ALLOC_MAX_BATCH_BYTES };
+		//spanĴС(ͬʱҲֵ)ͷС
+		enum ESpan { Span_bytes = 256 * 1024, Span_header = 64 };
+		static_assert(EAligns::Max_bytes <= ESpan::Span_bytes / 4,
+			"a span must hold several blocks of the largest size class");
 	private:
 		//free-listsĽڵ㹹죬Сڴ
 		union list_node {
 			char client[1];
 			union list_node *next;
 		};
-		static list_node *free_list[ENFreeLists::Free_list_num];	//
+		static list_node *free_list[ENFreeLists::Free_list_num];	//ڴص
+		//ֻ߳޸ġɱ̶߳ȡļ
+		//relaxedĶдƽ̨ͨдȼۣҪǰ׺ָ
+		struct relaxed_counter {
+			std::atomic<size_t> value;
+			constexpr relaxed_counter() :value(0) { }
+			size_t get() const { return value.load(std::memory_order_relaxed); }
+			void set(size_t n) { value.store(n, std::memory_order_relaxed); }
+			void add(size_t n) { set(get() + n); }
+			void sub(size_t n) { set(get() - n); }
+		};
+#if TINYSTL_ALLOC_STATS
+		//ÿ̻߳ۼƣsnapshotʱ
+		struct stat_block {
+			relaxed_counter allocations[ENFreeLists::Free_list_num];
+			relaxed_counter frees[ENFreeLists::Free_list_num];
+			relaxed_counter hits[ENFreeLists::Free_list_num];
+			relaxed_counter refills[ENFreeLists::Free_list_num];
+			relaxed_counter large_allocations;
+			relaxed_counter large_frees;
+			relaxed_counter span_allocs;
+			relaxed_counter leftover_bytes;
+		};
+		static stat_block central_stats;//û̻߳ʱļcentral_mutex
+#endif
+		//̻߳棬߳˳󱻹ҵabandonedϣȴ߳̽ӹ
+		//Ӳͷţspanͷ¼ownerָʼЧ
+		struct thread_cache {
+			std::atomic<list_node *> remote_free[ENFreeLists::Free_list_num];//߳ͷŻ
+			char padding[64];//remote_freeıֶι
+			list_node *free_list[ENFreeLists::Free_list_num];
+			relaxed_counter length[ENFreeLists::Free_list_num];//ÿfree-listе
+			size_t max_length[ENFreeLists::Free_list_num];//ÿfree-list
+			size_t batch[ENFreeLists::Free_list_num];//һrefillȡص
+			char *start_free;//߳зֵڴʼλ
+			char *end_free;//߳зֵڴؽλ
+			thread_cache *next_abandoned;
+			thread_cache *next_cache;//л洮ɵ
+#if TINYSTL_ALLOC_STATS
+			stat_block stats;
+#endif
+			thread_cache();
+		};
+		//spanͷλÿspanʼ
+		struct span {
+			thread_cache *owner;//зָspan̻߳棬ڴзֵΪnullptr
+			chunk_provider *provider;//spanԴ
+			span *next;//spanɵcentral_mutex
+			size_t free_bytes;//trimʱͳƵĿֽ
+			size_t idle_passes;//ٴtrimʱȫ
+		};
+		//߳˳ʱ̵߳Ļ
+		struct cache_guard {
+			thread_cache *cache;
+			cache_guard();
+			~cache_guard();
+		};
+		static thread_local thread_cache *local_cache;//̵߳Ļ
+		static thread_local bool cache_destroyed;//̵߳ĻѾ
+		static thread_cache *abandoned;//˳߳µĻ
+		static thread_cache *all_caches;//ȫ
+		static span *spans;//ȫspan
+		//̨˥̣߳Եع黹һϵspan
+		struct decay_worker {
+			std::thread worker;
+			std::mutex mutex;
+			std::condition_variable cv;
+			std::chrono::milliseconds interval;
+			bool stop;
+			decay_worker();
+			~decay_worker();
+			void halt();
+		};
+		static decay_worker& get_decay_worker();
 	private:
 		static char *start_free;//ڴʼλ
 		static char *end_free;//ڴؽλ
 		static size_t heap_size;// heap ռ丽ֵС
+		static std::mutex central_mutex;//free_liststart_freeend_freeheap_sizeabandonedall_cachesspans
 	private:
-		//bytesϵ8ı
+		//bytesϵsize classĴС
 		static size_t ROUND_UP(size_t bytes) {
-			return ((bytes + EAligns::EAlign128 - 1) & ~(EAligns::EAlign128 - 1));
+			return size_class_map::class_size(size_class_map::class_of(bytes));
 		}
 		//Сʹõnfree-listn0ʼ
 		static size_t FREELIST_INDEX(size_t bytes) {
-			return (((bytes)+EAligns::EAlign128 - 1) / EAligns::EAlign128 - 1);
+			return size_class_map::class_of(bytes);
+		}
+		static char *align_up(char *ptr, size_t alignment) {
+			return reinterpret_cast<char *>((reinterpret_cast<uintptr_t>(ptr) + alignment - 1) & ~static_cast<uintptr_t>(alignment - 1));
+		}
+		//ȡptrڵspan
+		static span *span_of(void *ptr) {
+			return reinterpret_cast<span *>(reinterpret_cast<uintptr_t>(ptr) & ~static_cast<uintptr_t>(ESpan::Span_bytes - 1));
 		}
 		//һСΪnĶ󣬲ܼСΪn鵽free-list
 		static void *refill(size_t n);
 		//һռ䣬nobjsСΪsize
 		//nobjs㣬nobjsܻή
-		static char *chunk_alloc(size_t size, size_t& nobjs);
+		//cacheΪnullptrʱڴз֣central_mutex
+		static char *chunk_alloc(size_t size, size_t& nobjs, thread_cache *cache);
+		//[first, last)ͷڵַĶsize classпҵfree-list
+		static void recycle_leftover(char *first, char *last, thread_cache *cache);
+		//size classĶ
+		static void *aligned_large_alloc(size_t bytes, size_t alignment);
+		static void aligned_large_free(void *ptr);
 		static size_t get_blocks(size_t bytes);
+		//̻߳дСΪbytesrefill
+		static size_t batch_limit(size_t bytes);
+		//ϵͳһSpan_bytesspanԼ黹ϵͳ
+		static void *span_alloc();
+		static void span_free(span *ptr);
+		static chunk_provider *default_provider();
+		static std::atomic<chunk_provider *> provider;//ǰspanԴ
+		//Ǽspancentral_mutex
+		static void add_span(span *new_span);
+		//̻߳еȫ(remote-free)free-listcentral_mutex
+		static void flush_cache(thread_cache *cache);
+		//黹min_passestrimȫеspanع黹ֽcentral_mutex
+		static size_t release_spans(size_t min_passes);
+		//free-listȡnobjs飬ʽأcentral_mutex
+		static list_node *fetch_batch(size_t index, size_t& nobjs);
+		//зֳnobjsСΪbytes鲢
+		static list_node *carve_batch(size_t bytes, size_t& nobjs, thread_cache *cache);
+		//firstlastһڴ
+		static void release_batch(size_t index, list_node *first, list_node *last);
+		//ҵownerremote-freeϣ
+		static void remote_release(thread_cache *owner, size_t index, list_node *node);
+		//ѷϵremote-free鲢free-listcentral_mutex
+		static void drain_abandoned(size_t index);
+		//̻߳дСΪbytesfree-list
+		static size_t cache_limit(size_t bytes);
+		//ȡñ̵߳Ļ棬߳˳׶ηnullptr
+		static thread_cache *get_cache();
+		static thread_cache *create_cache();
+		//̻߳δʱջremote-free飬ٴڴȡ
+		static void *cache_refill(thread_cache *cache, size_t bytes);
+		//̻߳еindexfree-listǰnobjs黹ڴ
+		static void cache_release(thread_cache *cache, size_t index, size_t nobjs);
+#if TINYSTL_ALLOC_STATS
+		//ۼӱ̵߳ļû̻߳ʱۼӵcentral_stats
+		static void count(thread_cache *cache, relaxed_counter stat_block::*counter);
+		static void count(thread_cache *cache, relaxed_counter (stat_block::*counters)[ENFreeLists::Free_list_num], size_t index);
+#endif
 
 	public:
+		//ͳƿգfree_bytesheap_sizeļֻTINYSTL_ALLOC_STATSΪ1ʱۼ
+		struct statistics {
+			struct size_class {
+				size_t block_size;//С
+				size_t allocations;//
+				size_t frees;//ͷŴ
+				size_t hits;//̻߳Ĵ
+				size_t refills;//refill
+				size_t free_bytes;//̻߳free-listгеֽ
+			};
+			size_class classes[ENFreeLists::Free_list_num];
+			size_t large_allocations;//顢ֱӽmallocķ
+			size_t large_frees;
+			size_t span_allocs;//chunk_allocϵͳspanĴ
+			size_t leftover_bytes;//ڴͷ϶յfree-listֽ
+			size_t heap_size;//ǰϵͳֽ
+		};
+		static statistics stats();
+		//ıJSONʽͳƿ
+		static void dump_stats(std::ostream& os, bool json = false);
+	private:
+#if TINYSTL_ALLOC_STATS
+		static void accumulate(statistics& result, const stat_block& st);
+#endif
+	public:
+
 		static void *allocate(size_t bytes);
 		static void deallocate(void *ptr, size_t bytes);
+		//alignment(2)ط䣬ͷʱ봫ͬbytesalignment
+		//alignmentAlignʱ벻İ汾ȼ
+		//СȡȻҪsize classཻmalloc
+		static void *allocate(size_t bytes, size_t alignment);
+		static void deallocate(void *ptr, size_t bytes, size_t alignment);
+		//¾ɴСͬһsize classʱԭطأ߶ʱrealloc
+		//ֻmin(old_sz, new_sz)ֽ
 		static void *reallocate(void *ptr, size_t old_sz, size_t new_sz);
+		static void *reallocate(void *ptr, size_t old_sz, size_t new_sz, size_t alignment);
+		//ѱ̻߳齻ڴأȫ鶼ѿеspan黹ϵͳ
+		//̻߳еԻʹڵspanռãع黹ֽ
+		static size_t trim();
+		//̨˥̣߳ÿintervalѿгһڵspan黹ϵͳintervalΪ0ʱֹͣ
+		static void set_decay(std::chrono::milliseconds interval);
+		//˺spanԴproviderspanȫ黹ǰһֱЧ
+		//nullptrʱָΪmalloc
+		static void set_chunk_provider(chunk_provider *new_provider);
 	};
 
 	//̬Աʼ
 	char *alloc::start_free = nullptr;
 	char *alloc::end_free = nullptr;
 	size_t alloc::heap_size = 0;
+	std::mutex alloc::central_mutex;
+	alloc::thread_cache *alloc::abandoned = nullptr;
+	alloc::thread_cache *alloc::all_caches = nullptr;
+#if TINYSTL_ALLOC_STATS
+	alloc::stat_block alloc::central_stats;
+#endif
+	alloc::span *alloc::spans = nullptr;
+	std::atomic<chunk_provider *> alloc::provider(nullptr);
+	thread_local alloc::thread_cache *alloc::local_cache = nullptr;
+	thread_local bool alloc::cache_destroyed = false;
 
-	alloc::list_node *alloc::free_list[alloc::ENFreeLists::Free_list_num] = {
-		nullptr,nullptr,nullptr,nullptr,
-		nullptr,nullptr,nullptr,nullptr,
-		nullptr,nullptr,nullptr,nullptr,
-		nullptr,nullptr,nullptr,nullptr,
-	};
+	alloc::list_node *alloc::free_list[alloc::ENFreeLists::Free_list_num] = { nullptr };
 	// ݴСȡĿ
 	inline size_t alloc::get_blocks(size_t bytes)
 	{
@@ -82,122 +524,668 @@ namespace Tiny_STL {
 			return 1;
 		}
 	}
+	inline size_t alloc::batch_limit(size_t bytes)
+	{
+		size_t limit = EBatch::Max_batch_bytes / bytes;
+		if (limit > EBatch::Max_batch)
+			limit = EBatch::Max_batch;
+		return limit < get_blocks(bytes) ? get_blocks(bytes) : limit;
+	}
+	// ̻߳Сݼ
+	inline size_t alloc::cache_limit(size_t bytes)
+	{
+		size_t limit = ECache::Cache_max_bytes / bytes;
+		if (limit > ECache::Cache_max_objs)
+			limit = ECache::Cache_max_objs;
+		if (limit < 2 * batch_limit(bytes))
+			limit = 2 * batch_limit(bytes);
+		return limit;
+	}
+
+	alloc::thread_cache::thread_cache()
+		:start_free(nullptr), end_free(nullptr), next_abandoned(nullptr), next_cache(nullptr) {
+		for (size_t i = 0; i < ENFreeLists::Free_list_num; ++i) {
+			remote_free[i].store(nullptr, std::memory_order_relaxed);
+			free_list[i] = nullptr;
+			max_length[i] = cache_limit(size_class_map::class_size(i));
+			batch[i] = get_blocks(size_class_map::class_size(i));
+		}
+	}
+	//ӹһѷĻ棬ûʱ½һ
+	alloc::cache_guard::cache_guard() {
+		{
+			std::lock_guard<std::mutex> lock(central_mutex);
+			cache = abandoned;
+			if (cache)
+				abandoned = cache->next_abandoned;
+		}
+		if (!cache) {
+			void *mem = malloc(sizeof(thread_cache));
+			if (!mem) {
+				std::cerr << "Out of memory !" << std::endl;
+				std::exit(1);
+			}
+			cache = new(mem) thread_cache();
+			std::lock_guard<std::mutex> lock(central_mutex);
+			cache->next_cache = all_caches;
+			all_caches = cache;
+		}
+		local_cache = cache;
+	}
+	//߳˳ѻеȫڴأ汾(ͬδзspan)һ߳
+	alloc::cache_guard::~cache_guard() {
+		local_cache = nullptr;
+		cache_destroyed = true;
+		std::lock_guard<std::mutex> lock(central_mutex);
+		flush_cache(cache);
+		cache->next_abandoned = abandoned;
+		abandoned = cache;
+		for (size_t i = 0; i < ENFreeLists::Free_list_num; ++i) {
+			drain_abandoned(i);
+		}
+	}
+	void alloc::flush_cache(thread_cache *cache) {
+		for (size_t i = 0; i < ENFreeLists::Free_list_num; ++i) {
+			list_node *first = cache->free_list[i];
+			if (first) {
+				list_node *last = first;
+				while (last->next)
+					last = last->next;
+				last->next = free_list[i];
+				free_list[i] = first;
+				cache->free_list[i] = nullptr;
+				cache->length[i].set(0);
+			}
+			first = cache->remote_free[i].exchange(nullptr, std::memory_order_acquire);
+			if (first) {
+				list_node *last = first;
+				while (last->next)
+					last = last->next;
+				last->next = free_list[i];
+				free_list[i] = first;
+			}
+		}
+	}
+
+	inline alloc::thread_cache *alloc::get_cache() {
+#if TINYSTL_ALLOC_THREAD_CACHE
+		if (local_cache)
+			return local_cache;
+		return create_cache();
+#else
+		return nullptr;
+#endif
+	}
+	//״ʹʱȡñ̵߳Ļ棬cache_guard߳˳ʱִ
+	inline alloc::thread_cache *alloc::create_cache() {
+		if (cache_destroyed)
+			return nullptr;
+		static thread_local cache_guard guard;
+		return guard.cache;
+	}
+
+	inline chunk_provider *alloc::default_provider() {
+		static malloc_chunk_provider malloc_provider;
+		return &malloc_provider;
+	}
+	void alloc::set_chunk_provider(chunk_provider *new_provider) {
+		provider.store(new_provider ? new_provider : default_provider(), std::memory_order_release);
+	}
+	inline void *alloc::span_alloc() {
+		chunk_provider *source = provider.load(std::memory_order_acquire);
+		if (!source)
+			source = default_provider();
+		span *result = static_cast<span *>(source->allocate(ESpan::Span_bytes));
+		if (result)
+			result->provider = source;
+		return result;
+	}
+	//spanĸԴͻĸԴ
+	inline void alloc::span_free(span *ptr) {
+		ptr->provider->deallocate(ptr, ESpan::Span_bytes);
+	}
+	inline void alloc::add_span(span *new_span) {
+		new_span->next = spans;
+		new_span->idle_passes = 0;
+		spans = new_span;
+		heap_size += ESpan::Span_bytes;
+		TINYSTL_ALLOC_STAT(central_stats.span_allocs.add(1));
+	}
 
 	//СΪbytesĿռ
 	void* alloc::allocate(size_t bytes) {
-		if (bytes > static_cast<size_t>(EAligns::EAlign2K)) {
+		thread_cache *cache = get_cache();
+		if (bytes > static_cast<size_t>(EAligns::Max_bytes)) {
+			TINYSTL_ALLOC_STAT(count(cache, &stat_block::large_allocations));
 			return malloc(bytes);
 		}
 		size_t index = FREELIST_INDEX(bytes);
-		list_node *list = free_list[index];
-		if (list) {       //listпռ
-			free_list[index] = list->next;
+		if (cache) {//·ֻʱ̵߳Ļ
+			TINYSTL_ALLOC_STAT(cache->stats.allocations[index].add(1));
+			list_node *list = cache->free_list[index];
+			if (list) {
+				TINYSTL_ALLOC_STAT(cache->stats.hits[index].add(1));
+				cache->free_list[index] = list->next;
+				cache->length[index].sub(1);
+				return list;
+			}
+			return cache_refill(cache, ROUND_UP(bytes));
+		}
+		std::lock_guard<std::mutex> lock(central_mutex);
+		TINYSTL_ALLOC_STAT(central_stats.allocations[index].add(1));
+		size_t nobjs = 1;
+		list_node *list = fetch_batch(index, nobjs);
+		if (list) {       //listпռ
+			TINYSTL_ALLOC_STAT(central_stats.hits[index].add(1));
 			return list;
 		}
-		else {//listû㹻Ŀռ䣬Ҫڴȡռ
+		else {//listû㹻Ŀռ䣬Ҫڴȡռ
+			TINYSTL_ALLOC_STAT(central_stats.refills[index].add(1));
 			return refill(ROUND_UP(bytes));
 		}
 	}
 	//ͷptrָĴСΪbytesĿռ䣬ptrΪnullptr
+	//̵߳spanʱҵ̵߳remote-free
 	void alloc::deallocate(void *ptr, size_t bytes) {
-		if (bytes > EAligns::EAlign2K) {
+		thread_cache *cache = get_cache();
+		if (bytes > EAligns::Max_bytes) {
+			TINYSTL_ALLOC_STAT(count(cache, &stat_block::large_frees));
 			free(ptr);
+			return;
 		}
-		else {
-			size_t index = FREELIST_INDEX(bytes);
-			list_node *node = static_cast<list_node *>(ptr);
-			node->next = free_list[index];
-			free_list[index] = node;
+		size_t index = FREELIST_INDEX(bytes);
+		list_node *node = static_cast<list_node *>(ptr);
+		thread_cache *owner = span_of(ptr)->owner;
+		TINYSTL_ALLOC_STAT(count(cache, &stat_block::frees, index));
+		if (owner && owner != cache) {
+			remote_release(owner, index, node);
+			return;
+		}
+		if (cache) {
+			node->next = cache->free_list[index];
+			cache->free_list[index] = node;
+			cache->length[index].add(1);
+			if (cache->length[index].get() > cache->max_length[index]) {
+				cache_release(cache, index, cache->length[index].get() / 2);
+			}
+			return;
+		}
+		release_batch(index, node, node);
+	}
+	//alignmentطСΪbytesĿռ䣬size classͨ·
+	void* alloc::allocate(size_t bytes, size_t alignment) {
+		if (alignment <= static_cast<size_t>(size_class_map::Align))
+			return allocate(bytes);
+		size_t index = size_class_map::aligned_class(bytes, alignment);
+		if (index == ENFreeLists::Free_list_num) {
+			TINYSTL_ALLOC_STAT(count(get_cache(), &stat_block::large_allocations));
+			return aligned_large_alloc(bytes, alignment);
+		}
+		return allocate(size_class_map::class_size(index));
+	}
+	void alloc::deallocate(void *ptr, size_t bytes, size_t alignment) {
+		if (alignment <= static_cast<size_t>(size_class_map::Align)) {
+			deallocate(ptr, bytes);
+			return;
+		}
+		size_t index = size_class_map::aligned_class(bytes, alignment);
+		if (index == ENFreeLists::Free_list_num) {
+			TINYSTL_ALLOC_STAT(count(get_cache(), &stat_block::large_frees));
+			aligned_large_free(ptr);
+			return;
+		}
+		deallocate(ptr, size_class_map::class_size(index));
+	}
+	inline void *alloc::aligned_large_alloc(size_t bytes, size_t alignment) {
+#ifdef _WIN32
+		void *result = _aligned_malloc(bytes, alignment);
+#else
+		void *result = nullptr;
+		if (posix_memalign(&result, alignment < sizeof(void *) ? sizeof(void *) : alignment, bytes) != 0)
+			result = nullptr;
+#endif
+		if (!result) {
+			std::cerr << "Out of memory !" << std::endl;
+			std::exit(1);
 		}
+		return result;
+	}
+	inline void alloc::aligned_large_free(void *ptr) {
+#ifdef _WIN32
+		_aligned_free(ptr);
+#else
+		free(ptr);
+#endif
 	}
-	//·ptrָĿռ䣬old_szСԭռΪnew_szС
+	//·ptrָĿռ䣬old_szСԭռΪnew_szСԭ
 	void* alloc::reallocate(void *ptr, size_t old_sz, size_t new_sz) {
+		if (!ptr)
+			return allocate(new_sz);
+		if (new_sz == 0) {
+			deallocate(ptr, old_sz);
+			return nullptr;
+		}
+		const size_t max_bytes = EAligns::Max_bytes;
+		if (old_sz <= max_bytes && new_sz <= max_bytes) {
+			if (FREELIST_INDEX(old_sz) == FREELIST_INDEX(new_sz))
+				return ptr;
+		}
+		else if (old_sz > max_bytes && new_sz > max_bytes) {
+			//鱾mallocreallocԭչglibcmmapõʹmremap
+			void *result = realloc(ptr, new_sz);
+			if (!result) {
+				std::cerr << "Out of memory !" << std::endl;
+				std::exit(1);
+			}
+			return result;
+		}
+		void *result = allocate(new_sz);
+		memcpy(result, ptr, old_sz < new_sz ? old_sz : new_sz);
 		deallocate(ptr, old_sz);
-		ptr = allocate(new_sz);
-		return ptr;
+		return result;
 	}
-	//һСΪnĶ󣬲ʱΪʵfree listӽڵ
-	//bytesѾϵΪ8ı
-	//free_list
-	void* alloc::refill(size_t bytes) {
-		size_t nobjs = get_blocks(bytes);
-		//ڴȡ
-		char *chunk = chunk_alloc(bytes, nobjs);
-		list_node **my_free_list = nullptr;
-		list_node *result = nullptr;
-		list_node *current_obj = nullptr, *next_obj = nullptr;
-
-		if (nobjs == 1) {//ȡĿռֻһʹ
-			return chunk;
+	//İ汾ֻ¾ɴСӳ䵽ͬһsize classʱԭط
+	void* alloc::reallocate(void *ptr, size_t old_sz, size_t new_sz, size_t alignment) {
+		if (alignment <= static_cast<size_t>(size_class_map::Align))
+			return reallocate(ptr, old_sz, new_sz);
+		if (!ptr)
+			return allocate(new_sz, alignment);
+		if (new_sz == 0) {
+			deallocate(ptr, old_sz, alignment);
+			return nullptr;
+		}
+		size_t index = size_class_map::aligned_class(old_sz, alignment);
+		if (index != ENFreeLists::Free_list_num && index == size_class_map::aligned_class(new_sz, alignment))
+			return ptr;
+		void *result = allocate(new_sz, alignment);
+		memcpy(result, ptr, old_sz < new_sz ? old_sz : new_sz);
+		deallocate(ptr, old_sz, alignment);
+		return result;
+	}
+	//̻߳Ϊգγremote-freefree-listͱ̵߳span
+	//һ飬ڻ
+	//δСÿδжֱbatch_limitʱ
+	//bytesѾϵΪsize classĴС
+	void* alloc::cache_refill(thread_cache *cache, size_t bytes) {
+		size_t index = FREELIST_INDEX(bytes);
+		size_t nobjs = cache->batch[index];
+		TINYSTL_ALLOC_STAT(cache->stats.refills[index].add(1));
+		list_node *result = cache->remote_free[index].exchange(nullptr, std::memory_order_acquire);
+		if (result) {//ջ߳ͷŵ
+			nobjs = 1;
+			for (list_node *p = result->next; p; p = p->next)
+				++nobjs;
 		}
 		else {
-			my_free_list = free_list + FREELIST_INDEX(bytes);
-			result = (list_node *)(chunk);
-			*my_free_list = next_obj = (list_node *)(chunk + bytes);
-			//ȡĶĿռ뵽Ӧfree listȥ
-			for (int i = 1;; ++i) {
-				current_obj = next_obj;
-				next_obj = (list_node *)((char *)next_obj + bytes);
-				if (nobjs - 1 == i) {
-					current_obj->next = 0;
-					break;
-				}
-				else {
-					current_obj->next = next_obj;
-				}
+			{
+				std::lock_guard<std::mutex> lock(central_mutex);
+				result = fetch_batch(index, nobjs);
 			}
-			return result;
+			if (!result)
+				result = carve_batch(bytes, nobjs, cache);
+			size_t limit = batch_limit(bytes);
+			cache->batch[index] = cache->batch[index] * 2 < limit ? cache->batch[index] * 2 : limit;
 		}
+		cache->free_list[index] = result->next;
+		cache->length[index].set(nobjs - 1);
+		return result;
+	}
+	//̻߳ժnobjs飬һԹһڴ
+	//˵ȡصˣ֮
+	void alloc::cache_release(thread_cache *cache, size_t index, size_t nobjs) {
+		if (cache->batch[index] > 1)
+			cache->batch[index] /= 2;
+		list_node *first = cache->free_list[index];
+		list_node *last = first;
+		for (size_t i = 1; i < nobjs; ++i) {
+			last = last->next;
+		}
+		cache->free_list[index] = last->next;
+		cache->length[index].sub(nobjs);
+		release_batch(index, first, last);
+	}
+	void alloc::release_batch(size_t index, list_node *first, list_node *last) {
+		std::lock_guard<std::mutex> lock(central_mutex);
+		last->next = free_list[index];
+		free_list[index] = first;
+	}
+	//Treiberջʽջownerһȡ˲ABA
+	inline void alloc::remote_release(thread_cache *owner, size_t index, list_node *node) {
+		std::atomic<list_node *>& head = owner->remote_free[index];
+		list_node *old_head = head.load(std::memory_order_relaxed);
+		do {
+			node->next = old_head;
+		} while (!head.compare_exchange_weak(old_head, node,
+			std::memory_order_release, std::memory_order_relaxed));
+	}
+	void alloc::drain_abandoned(size_t index) {
+		for (thread_cache *cache = abandoned; cache; cache = cache->next_abandoned) {
+			list_node *first = cache->remote_free[index].exchange(nullptr, std::memory_order_acquire);
+			if (!first)
+				continue;
+			list_node *last = first;
+			while (last->next)
+				last = last->next;
+			last->next = free_list[index];
+			free_list[index] = first;
+		}
+	}
+	//free-listΪʱȲ˳̵߳remote-free
+	alloc::list_node *alloc::fetch_batch(size_t index, size_t& nobjs) {
+		list_node **my_free_list = free_list + index;
+		if (!*my_free_list)
+			drain_abandoned(index);
+		if (!*my_free_list)
+			return nullptr;
+		list_node *first = *my_free_list, *last = first;
+		size_t n = 1;
+		for (; n < nobjs && last->next; ++n) {
+			last = last->next;
+		}
+		*my_free_list = last->next;
+		last->next = nullptr;
+		nobjs = n;
+		return first;
+	}
+	//bytesѾϵΪsize classĴС
+	alloc::list_node *alloc::carve_batch(size_t bytes, size_t& nobjs, thread_cache *cache) {
+		//ڴȡ
+		char *chunk = chunk_alloc(bytes, nobjs, cache);
+		list_node *current_obj = (list_node *)(chunk);
+		//ȡĿռ䴮
+		for (size_t i = 1; i < nobjs; ++i) {
+			list_node *next_obj = (list_node *)((char *)current_obj + bytes);
+			current_obj->next = next_obj;
+			current_obj = next_obj;
+		}
+		current_obj->next = nullptr;
+		return (list_node *)(chunk);
+	}
+	//һСΪnĶ󣬲ʱΪʵfree listӽڵ
+	//bytesѾϵΪsize classĴСcentral_mutex
+	//free_list
+	void* alloc::refill(size_t bytes) {
+		size_t nobjs = get_blocks(bytes);
+		list_node *result = carve_batch(bytes, nobjs, nullptr);
+		//ȡĶĿռ뵽Ӧfree listȥ
+		free_list[FREELIST_INDEX(bytes)] = result->next;
+		return result;
 	}
 
-	//bytesѾϵΪ8ı
-	//ڴȡռfree_list 
-	char *alloc::chunk_alloc(size_t bytes, size_t& nobjs) {
+	//bytesѾϵΪsize classĴС
+	//ڴȡռfree_list
+	//鰴size classȻз֣ǰĿ϶յСsize class
+	char *alloc::chunk_alloc(size_t bytes, size_t& nobjs, thread_cache *cache) {
+		char *&pool_start = cache ? cache->start_free : start_free;
+		char *&pool_end = cache ? cache->end_free : end_free;
+		list_node **lists = cache ? cache->free_list : free_list;
 		char *result = 0;
 		size_t total_bytes = bytes * nobjs;
-		size_t bytes_left = end_free - start_free;
+		size_t bytes_left = pool_end - pool_start;
+		size_t gap = align_up(pool_start, size_class_map::class_align(FREELIST_INDEX(bytes))) - pool_start;
 
-		if (bytes_left >= total_bytes) {//ڴʣռȫҪ
-			result = start_free;
-			start_free = start_free + total_bytes;
-			return result;
-		}
-		else if (bytes_left >= bytes) {//ڴʣռ䲻ȫҪ㹻Ӧһϵ
-			nobjs = bytes_left / bytes;//nobjsС
-			total_bytes = nobjs * bytes;
-			result = start_free;
-			start_free += total_bytes;
+		if (bytes_left >= gap + bytes) {
+			recycle_leftover(pool_start, pool_start + gap, cache);
+			pool_start += gap;
+			bytes_left -= gap;
+			if (bytes_left < total_bytes) {//ڴʣռ䲻ȫҪ㹻Ӧһϵ
+				nobjs = bytes_left / bytes;//nobjsС
+				total_bytes = nobjs * bytes;
+			}
+			result = pool_start;
+			pool_start += total_bytes;
 			return result;
 		}
-		else {//ڴʣռһĴС޷ṩ
-			//heapռ
-			size_t bytes_to_get = 2 * total_bytes + ROUND_UP(heap_size >> 4);
-			if (bytes_left > 0) {
-				list_node **my_free_list = free_list + FREELIST_INDEX(bytes_left);
-				((list_node *)start_free)->next = *my_free_list;
-				*my_free_list = (list_node *)start_free;
-			}
-			start_free = (char *)malloc(bytes_to_get);
-			if (!start_free) {
-				list_node **my_free_list = nullptr, *p = nullptr;
-				for (int i = 0; i <= EAligns::EAlign2K; i += EAligns::EAlign128) {
-					my_free_list = free_list + FREELIST_INDEX(i);
-					p = *my_free_list;
+		else {//ڴʣռһ鶼޷ṩ
+			recycle_leftover(pool_start, pool_end, cache);
+			pool_start = pool_end;
+			//һµspan
+			span *new_span = static_cast<span *>(span_alloc());
+			if (!new_span) {
+				//free-listһ㹻䵱ڴ
+				for (size_t index = FREELIST_INDEX(bytes); index < ENFreeLists::Free_list_num; ++index) {
+					list_node *p = lists[index];
 					if (p != 0) {
-						*my_free_list = p->next;
-						start_free = (char *)p;
-						end_free = start_free + i;
-						return chunk_alloc(bytes, nobjs);
+						lists[index] = p->next;
+						if (cache)
+							cache->length[index].sub(1);
+						pool_start = (char *)p;
+						pool_end = pool_start + size_class_map::class_size(index);
+						return chunk_alloc(bytes, nobjs, cache);
 					}
 				}
-				end_free = nullptr;
+				pool_start = pool_end = nullptr;
 				std::cerr << "Out of memory !" << std::endl;
 				std::exit(1);
 			}
-			heap_size += bytes_to_get;
-			end_free = start_free + bytes_to_get;
-			return chunk_alloc(bytes, nobjs);
+			new_span->owner = cache;
+			if (cache) {
+				std::lock_guard<std::mutex> lock(central_mutex);
+				add_span(new_span);
+			}
+			else {
+				add_span(new_span);
+			}
+			pool_start = (char *)new_span + ESpan::Span_header;
+			pool_end = (char *)new_span + ESpan::Span_bytes;
+			return chunk_alloc(bytes, nobjs, cache);
+		}
+	}
+
+	void alloc::recycle_leftover(char *first, char *last, thread_cache *cache) {
+		list_node **lists = cache ? cache->free_list : free_list;
+		size_t bytes_left = last - first;
+		TINYSTL_ALLOC_STAT((cache ? cache->stats : central_stats).leftover_bytes.add(bytes_left));
+		while (bytes_left >= static_cast<size_t>(size_class_map::Align)) {
+			size_t index = size_class_map::floor_class(bytes_left);
+			while (reinterpret_cast<uintptr_t>(first) & (size_class_map::class_align(index) - 1))
+				--index;
+			size_t block = size_class_map::class_size(index);
+			((list_node *)first)->next = lists[index];
+			lists[index] = (list_node *)first;
+			if (cache)
+				cache->length[index].add(1);
+			first += block;
+			bytes_left -= block;
+		}
+	}
+
+	//spanĿֽSpan_bytes-Span_headerʱзֳȫfree-list
+	//ĳ߳зֵspanʣಿֲֽڣ˲ᱻ黹
+	//̵߳ڴǡþʱʹ黹ҲֻȽָٷڴ
+	size_t alloc::release_spans(size_t min_passes) {
+		const size_t span_capacity = ESpan::Span_bytes - ESpan::Span_header;
+		for (span *s = spans; s; s = s->next)
+			s->free_bytes = 0;
+		for (size_t i = 0; i < ENFreeLists::Free_list_num; ++i) {
+			for (list_node *p = free_list[i]; p; p = p->next)
+				span_of(p)->free_bytes += size_class_map::class_size(i);
+		}
+		//ڴѷڴزٱʹãʣಿ
+		if (start_free != end_free)
+			span_of(start_free - 1)->free_bytes += end_free - start_free;
+		for (thread_cache *cache = abandoned; cache; cache = cache->next_abandoned) {
+			if (cache->start_free != cache->end_free)
+				span_of(cache->start_free - 1)->free_bytes += cache->end_free - cache->start_free;
+		}
+		bool any = false;
+		for (span *s = spans; s; s = s->next) {
+			if (s->free_bytes != span_capacity) {
+				s->idle_passes = 0;
+			}
+			else if (s->idle_passes < min_passes) {
+				++s->idle_passes;
+				s->free_bytes = 0;
+			}
+			else {
+				any = true;
+			}
+		}
+		if (!any)
+			return 0;
+		//free-listժ黹span
+		for (size_t i = 0; i < ENFreeLists::Free_list_num; ++i) {
+			list_node **link = free_list + i;
+			while (*link) {
+				if (span_of(*link)->free_bytes == span_capacity)
+					*link = (*link)->next;
+				else
+					link = &(*link)->next;
+			}
+		}
+		if (start_free != end_free && span_of(start_free - 1)->free_bytes == span_capacity)
+			start_free = end_free = nullptr;
+		for (thread_cache *cache = abandoned; cache; cache = cache->next_abandoned) {
+			if (cache->start_free != cache->end_free && span_of(cache->start_free - 1)->free_bytes == span_capacity)
+				cache->start_free = cache->end_free = nullptr;
+		}
+		size_t released = 0;
+		span **link = &spans;
+		while (*link) {
+			span *s = *link;
+			if (s->free_bytes == span_capacity) {
+				*link = s->next;
+				span_free(s);
+				heap_size -= ESpan::Span_bytes;
+				released += ESpan::Span_bytes;
+			}
+			else {
+				link = &s->next;
+			}
+		}
+		return released;
+	}
+	size_t alloc::trim() {
+		std::lock_guard<std::mutex> lock(central_mutex);
+		if (local_cache)
+			flush_cache(local_cache);
+		for (size_t i = 0; i < ENFreeLists::Free_list_num; ++i)
+			drain_abandoned(i);
+		return release_spans(0);
+	}
+
+	alloc::decay_worker::decay_worker()
+		:interval(0), stop(false) { }
+	alloc::decay_worker::~decay_worker() {
+		halt();
+	}
+	void alloc::decay_worker::halt() {
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			stop = true;
+		}
+		cv.notify_all();
+		if (worker.joinable())
+			worker.join();
+	}
+	inline alloc::decay_worker& alloc::get_decay_worker() {
+		static decay_worker decay;
+		return decay;
+	}
+	//ÿֻ黹һھȫеspanͷŵspan黹
+	void alloc::set_decay(std::chrono::milliseconds interval) {
+		decay_worker& decay = get_decay_worker();
+		decay.halt();
+		if (interval.count() <= 0)
+			return;
+		decay.interval = interval;
+		decay.stop = false;
+		decay.worker = std::thread([&decay]() {
+			std::unique_lock<std::mutex> lock(decay.mutex);
+			while (!decay.cv.wait_for(lock, decay.interval, [&decay]() { return decay.stop; })) {
+				std::lock_guard<std::mutex> central_lock(central_mutex);
+				for (size_t i = 0; i < ENFreeLists::Free_list_num; ++i)
+					drain_abandoned(i);
+				release_spans(1);
+			}
+		});
+	}
+
+#if TINYSTL_ALLOC_STATS
+	inline void alloc::count(thread_cache *cache, relaxed_counter stat_block::*counter) {
+		if (cache) {
+			(cache->stats.*counter).add(1);
+			return;
+		}
+		std::lock_guard<std::mutex> lock(central_mutex);
+		(central_stats.*counter).add(1);
+	}
+	inline void alloc::count(thread_cache *cache, relaxed_counter (stat_block::*counters)[ENFreeLists::Free_list_num], size_t index) {
+		if (cache) {
+			(cache->stats.*counters)[index].add(1);
+			return;
+		}
+		std::lock_guard<std::mutex> lock(central_mutex);
+		(central_stats.*counters)[index].add(1);
+	}
+#endif
+
+	alloc::statistics alloc::stats() {
+		statistics result = statistics();
+		std::lock_guard<std::mutex> lock(central_mutex);
+		for (size_t i = 0; i < ENFreeLists::Free_list_num; ++i) {
+			statistics::size_class& sc = result.classes[i];
+			sc.block_size = size_class_map::class_size(i);
+			for (list_node *p = free_list[i]; p; p = p->next)
+				sc.free_bytes += sc.block_size;
+			for (thread_cache *cache = all_caches; cache; cache = cache->next_cache)
+				sc.free_bytes += cache->length[i].get() * sc.block_size;
+		}
+		result.heap_size = heap_size;
+#if TINYSTL_ALLOC_STATS
+		accumulate(result, central_stats);
+		for (thread_cache *cache = all_caches; cache; cache = cache->next_cache)
+			accumulate(result, cache->stats);
+#endif
+		return result;
+	}
+#if TINYSTL_ALLOC_STATS
+	void alloc::accumulate(statistics& result, const stat_block& st) {
+		for (size_t i = 0; i < ENFreeLists::Free_list_num; ++i) {
+			result.classes[i].allocations += st.allocations[i].get();
+			result.classes[i].frees += st.frees[i].get();
+			result.classes[i].hits += st.hits[i].get();
+			result.classes[i].refills += st.refills[i].get();
+		}
+		result.large_allocations += st.large_allocations.get();
+		result.large_frees += st.large_frees.get();
+		result.span_allocs += st.span_allocs.get();
+		result.leftover_bytes += st.leftover_bytes.get();
+	}
+#endif
+	void alloc::dump_stats(std::ostream& os, bool json) {
+		statistics st = stats();
+		const size_t class_num = sizeof(st.classes) / sizeof(st.classes[0]);
+		if (json) {
+			os << "{\"heap_size\":" << st.heap_size
+				<< ",\"span_allocs\":" << st.span_allocs
+				<< ",\"leftover_bytes\":" << st.leftover_bytes
+				<< ",\"large_allocations\":" << st.large_allocations
+				<< ",\"large_frees\":" << st.large_frees
+				<< ",\"classes\":[";
+			for (size_t i = 0; i < class_num; ++i) {
+				const statistics::size_class& sc = st.classes[i];
+				os << (i ? "," : "") << "{\"block_size\":" << sc.block_size
+					<< ",\"allocations\":" << sc.allocations
+					<< ",\"frees\":" << sc.frees
+					<< ",\"hits\":" << sc.hits
+					<< ",\"refills\":" << sc.refills
+					<< ",\"free_bytes\":" << sc.free_bytes << "}";
+			}
+			os << "]}" << std::endl;
+			return;
+		}
+		os << "heap_size " << st.heap_size << ", span_allocs " << st.span_allocs
+			<< ", leftover_bytes " << st.leftover_bytes
+			<< ", large_allocations " << st.large_allocations
+			<< ", large_frees " << st.large_frees << '\n';
+		os << "size\tallocs\tfrees\thits\trefills\tfree_bytes\n";
+		for (size_t i = 0; i < class_num; ++i) {
+			const statistics::size_class& sc = st.classes[i];
+			os << sc.block_size << '\t' << sc.allocations << '\t' << sc.frees << '\t'
+				<< sc.hits << '\t' << sc.refills << '\t' << sc.free_bytes << '\n';
 		}
+		os.flush();
 	}
 }
 //namespace Tiny_STL .
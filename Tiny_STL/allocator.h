@@ -2,14 +2,18 @@
 #ifndef TINYSTL_ALLOCATOR_H
 #define TINYSTL_ALLOCATOR_H
 #include"alloc.h"
+#include"uninitialized.h"
+#include<type_traits>
+#include<utility>
 
 namespace Tiny_STL {
 	//allocatorģ
 	//ͺͿռ
-	//allocate:ڴķ䣬汾
+	//allocate:ڴķ䣬汾alignof(T)
 	//deallocate:ڴ٣ͬ汾
-	//constructor:ڷõڴϹʵĶ
-	//destroy:ʵ
+	//reallocate:ɰֽڿĶĴСԭ
+	//constructor:ڷõڴϾ͵عʵĶ󣬲ԭתTĹ캯
+	//destroy:ʵ󣬿ƽʲôҲ
 	template<typename T>
 	class allocator {
 	public:
@@ -25,8 +29,9 @@ namespace Tiny_STL {
 		static T* allocate(size_t n);
 		static bool deallocate(T* ptr);
 		static bool deallocate(T* ptr, size_t n);
-		static void construct(T *ptr);
-		static void construct(T *ptr, T&& value);
+		static T* reallocate(T* ptr, size_t old_n, size_t new_n);
+		template<typename... Args>
+		static void construct(T *ptr, Args&&... args);
 		static void destroy(T *ptr);
 		static void destroy(T *first, T *last);
 	};
@@ -34,19 +39,19 @@ namespace Tiny_STL {
 	//޲ΰ汾ڴʼλ
 	template<typename T>
 	inline T* allocator<T>::allocate() {
-		return static_cast<T*>(alloc::allocate(sizeof(T)));
+		return static_cast<T*>(alloc::allocate(sizeof(T), alignof(T)));
 	}
 	//ָҪĶ
 	template<typename T>
 	inline T* allocator<T>::allocate(size_t n) {
 		if (n == 0)return nullptr;
-		return static_cast<T *>(alloc::allocate(sizeof(T) * n));
+		return static_cast<T *>(alloc::allocate(sizeof(T) * n, alignof(T)));
 	}
 	//һָ룬ͷڴ棬ɹ򷵻true,false
 	template<typename T>
 	inline bool allocator<T>::deallocate(T* ptr) {
 		if (ptr == nullptr)return false;
-		alloc::deallocate(static_cast<void *>(ptr), sizeof(T));
+		alloc::deallocate(static_cast<void *>(ptr), sizeof(T), alignof(T));
 		return true;
 	}
 	
@@ -54,18 +59,22 @@ namespace Tiny_STL {
 	template<typename T>
 	inline bool allocator<T>::deallocate(T* ptr , size_t n) {
 		if (ptr == nullptr)return false;
-		alloc::deallocate(static_cast<void *>(ptr), sizeof(T)*n);
+		alloc::deallocate(static_cast<void *>(ptr), sizeof(T)*n, alignof(T));
 		return true;
 	}
-	//ڴϹ
+	//old_nĿռΪnew_nֻڿ԰ֽڿ
 	template<typename T>
-	inline void allocator<T>::construct(T *ptr) {
-		new(static_cast<void *>(ptr))T();
+	inline T* allocator<T>::reallocate(T* ptr, size_t old_n, size_t new_n) {
+		static_assert(std::is_trivially_copyable<T>::value,
+			"allocator<T>::reallocate requires a trivially copyable T");
+		return static_cast<T *>(alloc::reallocate(static_cast<void *>(ptr), sizeof(T) * old_n, sizeof(T) * new_n, alignof(T)));
 	}
+	//ڴϹ󣬲ʱ
 	//ҽ(universal ref)
 	template<typename T>
-	void allocator<T>::construct(T *ptr,T&& value) {
-		new(static_cast<void *>(ptr))T(std::forward<T>(value));
+	template<typename... Args>
+	inline void allocator<T>::construct(T *ptr, Args&&... args) {
+		new(static_cast<void *>(ptr))T(std::forward<Args>(args)...);
 	}
 	template<typename T>
 	inline void allocator<T>::destroy(T *ptr) {
@@ -74,9 +83,7 @@ namespace Tiny_STL {
 	//һָ루汾
 	template<typename T>
 	inline void allocator<T>::destroy(T *first, T *last) {
-		for (; first != last; ++first) {
-			first->~T();
-		}
+		Tiny_STL::destroy(first, last);
 	}
 }
 #endif // !TINYSTL_ALLOCATOR_H
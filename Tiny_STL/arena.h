@@ -0,0 +1,214 @@
+#pragma once
+#ifndef TINYSTL_ARENA_H
+#define TINYSTL_ARENA_H
+#include"allocator.h"
+#include<cstddef>
+#include<cstdint>
+#include<cstdlib>
+#include<cstring>
+#include<iostream>
+
+//monotonic arena : bump-pointer allocation, no-op deallocation and bulk release by reset()
+
+namespace Tiny_STL {
+
+	class arena
+	{
+	public:
+		enum { Default_block = 64 * 1024, Max_block = 1024 * 1024 };
+
+		explicit arena(size_t block_bytes = Default_block)
+			: head(nullptr), cur(nullptr), end(nullptr), next_block(block_bytes ? block_bytes : static_cast<size_t>(Default_block)),
+			first_block(next_block), used(0), initial(nullptr), initial_end(nullptr) { }
+		// start from a caller-supplied buffer which is never freed by the arena
+		arena(void *buffer, size_t bytes)
+			: head(nullptr), cur(static_cast<char *>(buffer)), end(static_cast<char *>(buffer) + bytes),
+			next_block(Default_block), first_block(Default_block), used(0),
+			initial(static_cast<char *>(buffer)), initial_end(end) { }
+		arena(const arena&) = delete;
+		arena& operator=(const arena&) = delete;
+		~arena() { release(); }
+
+		void *allocate(size_t bytes, size_t alignment = alignof(std::max_align_t));
+		// memory is only given back by reset() or the destructor
+		void deallocate(void *, size_t) { }
+		// grow the most recent allocation in place when it is still at the top of the arena
+		bool try_extend(void *ptr, size_t old_bytes, size_t new_bytes);
+
+		// drop every allocation at once, keep the newest block for reuse
+		void reset();
+		// bytes handed out since construction or the last reset()
+		size_t bytes_used() const { return used; }
+
+		// the arena used by arena_allocator on this thread
+		static arena& current();
+
+	private:
+		struct block {
+			block *next;
+			size_t size;
+		};
+		enum { Header = (sizeof(block) + alignof(std::max_align_t) - 1) & ~(alignof(std::max_align_t) - 1) };
+
+		void *allocate_slow(size_t bytes, size_t alignment);
+		void release();
+		static char *align_up(char *p, size_t alignment) {
+			return reinterpret_cast<char *>((reinterpret_cast<uintptr_t>(p) + alignment - 1) & ~(uintptr_t)(alignment - 1));
+		}
+
+		block *head;        // newest block first
+		char *cur;          // bump pointer
+		char *end;
+		size_t next_block;  // size of the next block, doubles up to Max_block
+		size_t first_block;
+		size_t used;
+		char *initial;      // caller-supplied buffer, if any
+		char *initial_end;
+
+		// a function-local thread_local, so that the header can be included from several translation units
+		static arena*& current_arena() {
+			static thread_local arena *ptr = nullptr;
+			return ptr;
+		}
+		friend class arena_scope;
+	};
+
+	// make an arena the current one of this thread for the lifetime of the scope
+	class arena_scope
+	{
+	public:
+		explicit arena_scope(arena& a) : previous(arena::current_arena()) { arena::current_arena() = &a; }
+		arena_scope(const arena_scope&) = delete;
+		arena_scope& operator=(const arena_scope&) = delete;
+		~arena_scope() { arena::current_arena() = previous; }
+	private:
+		arena *previous;
+	};
+
+	inline arena& arena::current()
+	{
+		if (arena *a = current_arena())
+			return *a;
+		static thread_local arena thread_arena;
+		return thread_arena;
+	}
+
+	inline void *arena::allocate(size_t bytes, size_t alignment)
+	{
+		char *p = align_up(cur, alignment);
+		if (cur && p + bytes <= end) {
+			cur = p + bytes;
+			used += bytes;
+			return p;
+		}
+		return allocate_slow(bytes, alignment);
+	}
+
+	inline void *arena::allocate_slow(size_t bytes, size_t alignment)
+	{
+		size_t need = bytes + alignment + Header;
+		size_t size = next_block;
+		while (size < need)
+			size *= 2;
+		block *b = static_cast<block *>(malloc(size));
+		if (!b) {
+			std::cerr << "Out of memory !" << std::endl;
+			std::exit(1);
+		}
+		b->size = size;
+		b->next = head;
+		head = b;
+		cur = reinterpret_cast<char *>(b) + Header;
+		end = reinterpret_cast<char *>(b) + size;
+		if (next_block < Max_block)
+			next_block *= 2;
+		char *p = align_up(cur, alignment);
+		cur = p + bytes;
+		used += bytes;
+		return p;
+	}
+
+	inline bool arena::try_extend(void *ptr, size_t old_bytes, size_t new_bytes)
+	{
+		char *p = static_cast<char *>(ptr);
+		if (p + old_bytes != cur || p + new_bytes > end)
+			return false;
+		cur = p + new_bytes;
+		used = used - old_bytes + new_bytes;
+		return true;
+	}
+
+	inline void arena::reset()
+	{
+		used = 0;
+		if (!head) {
+			cur = initial;
+			end = initial_end;
+			return;
+		}
+		// keep the newest (largest) block, free the rest
+		block *keep = head;
+		block *b = keep->next;
+		while (b) {
+			block *next = b->next;
+			free(b);
+			b = next;
+		}
+		keep->next = nullptr;
+		head = keep;
+		cur = reinterpret_cast<char *>(keep) + Header;
+		end = reinterpret_cast<char *>(keep) + keep->size;
+	}
+
+	inline void arena::release()
+	{
+		while (head) {
+			block *next = head->next;
+			free(head);
+			head = next;
+		}
+		cur = initial;
+		end = initial_end;
+		next_block = first_block;
+		used = 0;
+	}
+
+
+	// allocator backed by arena::current(), with the same static interface as allocator<T>
+	// deallocate is a no-op, memory is reclaimed in bulk by arena::reset()
+	template<typename T>
+	class arena_allocator :public allocator<T>
+	{
+	public:
+		static T* allocate() {
+			return static_cast<T *>(arena::current().allocate(sizeof(T), alignof(T)));
+		}
+		static T* allocate(size_t n) {
+			if (n == 0)return nullptr;
+			return static_cast<T *>(arena::current().allocate(sizeof(T) * n, alignof(T)));
+		}
+		static bool deallocate(T* ptr) {
+			return ptr != nullptr;
+		}
+		static bool deallocate(T* ptr, size_t) {
+			return ptr != nullptr;
+		}
+		// extends in place when ptr is the latest allocation of the arena
+		static T* reallocate(T* ptr, size_t old_n, size_t new_n);
+	};
+
+	template<typename T>
+	inline T* arena_allocator<T>::reallocate(T* ptr, size_t old_n, size_t new_n) {
+		static_assert(std::is_trivially_copyable<T>::value,
+			"arena_allocator<T>::reallocate requires a trivially copyable T");
+		if (!ptr)
+			return allocate(new_n);
+		arena& a = arena::current();
+		if (new_n <= old_n || a.try_extend(ptr, sizeof(T) * old_n, sizeof(T) * new_n))
+			return ptr;
+		T* result = allocate(new_n);
+		memcpy(static_cast<void *>(result), ptr, sizeof(T) * old_n);
+		return result;
+	}
+}
+#endif // !TINYSTL_ARENA_H
@@ -0,0 +1,183 @@
+#pragma once
+#ifndef TINYSTL_CONCURRENT_HASH_MAP_H
+#define TINYSTL_CONCURRENT_HASH_MAP_H
+#include"flat_hash_map.h"
+#include<cstddef>
+#include<mutex>
+#include<shared_mutex>
+#include<tuple>
+#include<utility>
+
+//hash map shared between threads, split into Shards independent flat_hash_maps
+//each shard has its own reader/writer lock: lookups take it shared and never block each other,
+//writers only block the shard their key falls in
+//a key is hashed once, the same hash picks the shard and is handed to the map inside it
+//no reference to an element ever escapes a lock, values are copied out or handed to a visitor
+
+namespace Tiny_STL {
+
+	template<typename Key, typename T, typename Hash = hash<Key>, typename KeyEqual = equal_to<Key>,
+		size_t Shards = 16>
+	class concurrent_hash_map {
+		static_assert(Shards > 0 && (Shards & (Shards - 1)) == 0, "concurrent_hash_map: Shards must be a power of two");
+	public:
+		typedef Key						key_type;
+		typedef T						mapped_type;
+		typedef std::pair<const Key, T>	value_type;
+		typedef Hash					hasher;
+		typedef KeyEqual				key_equal;
+		typedef size_t					size_type;
+
+	private:
+		typedef flat_hash_map<Key, T, Hash, KeyEqual> map_type;
+		typedef std::shared_timed_mutex mutex_type;
+		typedef std::shared_lock<mutex_type> read_lock;
+		typedef std::unique_lock<mutex_type> write_lock;
+
+		//one cache line per shard at least, so that locking one does not invalidate its neighbours
+		struct alignas(64) shard {
+			mutable mutex_type mutex;
+			map_type map;
+		};
+
+		hasher hash_fn;
+		shard shards[Shards];
+
+	public:
+		concurrent_hash_map() { }
+		concurrent_hash_map(const concurrent_hash_map&) = delete;
+		concurrent_hash_map& operator=(const concurrent_hash_map&) = delete;
+
+	public:
+		//lookup, under the shard's shared lock
+		//copies the mapped value into value, returns false when key is absent
+		bool find(const key_type& key, mapped_type& value) const {
+			size_t h = hash_fn(key);
+			const shard& s = shards[shard_index(h)];
+			read_lock lock(s.mutex);
+			typename map_type::const_iterator it = s.map.find(key, h);
+			if (it == s.map.end())
+				return false;
+			value = it->second;
+			return true;
+		}
+		bool contains(const key_type& key) const {
+			size_t h = hash_fn(key);
+			const shard& s = shards[shard_index(h)];
+			read_lock lock(s.mutex);
+			return s.map.contains(key, h);
+		}
+		//calls f(const value_type&) on the element of key, returns false when there is none
+		template<typename F>
+		bool cvisit(const key_type& key, F f) const {
+			size_t h = hash_fn(key);
+			const shard& s = shards[shard_index(h)];
+			read_lock lock(s.mutex);
+			typename map_type::const_iterator it = s.map.find(key, h);
+			if (it == s.map.end())
+				return false;
+			f(*it);
+			return true;
+		}
+		template<typename F>
+		bool visit(const key_type& key, F f) const { return cvisit(key, f); }
+		//calls f(const value_type&) on every element, one shard at a time
+		template<typename F>
+		void cvisit_all(F f) const {
+			for (const shard& s : shards) {
+				read_lock lock(s.mutex);
+				for (const value_type& v : s.map)
+					f(v);
+			}
+		}
+
+		//modifiers, under the shard's exclusive lock
+		//calls f(value_type&) on the element of key and may change its mapped value
+		template<typename F>
+		bool visit(const key_type& key, F f) {
+			size_t h = hash_fn(key);
+			shard& s = shards[shard_index(h)];
+			write_lock lock(s.mutex);
+			typename map_type::iterator it = s.map.find(key, h);
+			if (it == s.map.end())
+				return false;
+			f(*it);
+			return true;
+		}
+		template<typename F>
+		void visit_all(F f) {
+			for (shard& s : shards) {
+				write_lock lock(s.mutex);
+				for (value_type& v : s.map)
+					f(v);
+			}
+		}
+		//returns true when key was inserted, false when an existing value was replaced
+		template<typename M>
+		bool insert_or_assign(const key_type& key, M&& obj) {
+			size_t h = hash_fn(key);
+			shard& s = shards[shard_index(h)];
+			write_lock lock(s.mutex);
+			std::pair<typename map_type::iterator, bool> r = emplace(s, h, key, std::forward<M>(obj));
+			if (!r.second)
+				r.first->second = std::forward<M>(obj);
+			return r.second;
+		}
+		//does nothing when key is already present
+		template<typename... Args>
+		bool try_emplace(const key_type& key, Args&&... args) {
+			size_t h = hash_fn(key);
+			shard& s = shards[shard_index(h)];
+			write_lock lock(s.mutex);
+			return emplace(s, h, key, std::forward<Args>(args)...).second;
+		}
+		bool insert(const value_type& value) { return try_emplace(value.first, value.second); }
+		bool erase(const key_type& key) {
+			size_t h = hash_fn(key);
+			shard& s = shards[shard_index(h)];
+			write_lock lock(s.mutex);
+			return s.map.erase(key, h) != 0;
+		}
+		void clear() {
+			for (shard& s : shards) {
+				write_lock lock(s.mutex);
+				s.map.clear();
+			}
+		}
+		//spreads the room for n elements over the shards
+		void reserve(size_type n) {
+			for (shard& s : shards) {
+				write_lock lock(s.mutex);
+				s.map.reserve((n + Shards - 1) / Shards);
+			}
+		}
+
+		//the sum over the shards, exact only when no writer runs meanwhile
+		size_type size() const {
+			size_type n = 0;
+			for (const shard& s : shards) {
+				read_lock lock(s.mutex);
+				n += s.map.size();
+			}
+			return n;
+		}
+		bool empty() const { return size() == 0; }
+		static constexpr size_type shard_count() { return Shards; }
+
+	private:
+		//the top bits of the mixed hash pick the shard, the maps inside index with the lower ones
+		static size_t shard_index(size_t h) {
+			return Shards == 1 ? 0 : static_cast<size_t>(hash_mix(static_cast<uint64_t>(h)) >> (64 - log2(Shards)));
+		}
+		static constexpr unsigned log2(size_t n) { return n <= 1 ? 0 : 1 + log2(n >> 1); }
+		//try_emplace on the shard's map with the hash already known, the caller holds the lock
+		template<typename... Args>
+		static std::pair<typename map_type::iterator, bool> emplace(shard& s, size_t h, const key_type& key, Args&&... args) {
+			return s.map.emplace_hashed(h, key, std::piecewise_construct, std::forward_as_tuple(key),
+				std::forward_as_tuple(std::forward<Args>(args)...));
+		}
+	};
+
+}
+
+#endif // !TINYSTL_CONCURRENT_HASH_MAP_H
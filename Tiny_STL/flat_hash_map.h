@@ -0,0 +1,97 @@
+#pragma once
+#ifndef TINYSTL_FLAT_HASH_MAP_H
+#define TINYSTL_FLAT_HASH_MAP_H
+#include"flat_hash_table.h"
+#include<stdexcept>
+#include<tuple>
+
+//unordered map stored in one open addressing table, see flat_hash_table.h
+//elements live in the table itself: rehashing moves them, so references and iterators are
+//invalidated by insertions that grow the table, but never by erase
+
+namespace Tiny_STL {
+
+	template<typename Key, typename T>
+	struct __flat_map_policy {
+		typedef Key key_type;
+		typedef std::pair<const Key, T> value_type;
+		enum { constant_iterators = false };
+		static const Key& key(const value_type& value) { return value.first; }
+	};
+
+
+	template<typename Key, typename T, typename Hash = hash<Key>, typename KeyEqual = equal_to<Key>,
+		typename Alloc = allocator<std::pair<const Key, T>>>
+	class flat_hash_map :public __flat_hash_table<__flat_map_policy<Key, T>, Hash, KeyEqual, Alloc> {
+		typedef __flat_hash_table<__flat_map_policy<Key, T>, Hash, KeyEqual, Alloc> table;
+	public:
+		typedef T	mapped_type;
+		typedef typename table::key_type		key_type;
+		typedef typename table::value_type		value_type;
+		typedef typename table::size_type		size_type;
+		typedef typename table::iterator		iterator;
+		typedef typename table::const_iterator	const_iterator;
+
+	public:
+		using table::table;
+		flat_hash_map() { }
+		flat_hash_map& operator=(std::initializer_list<value_type> il) {
+			table::operator=(il);
+			return *this;
+		}
+
+	public:
+		//element access
+		T& operator[](const key_type& key) { return try_emplace(key).first->second; }
+		T& operator[](key_type&& key) { return try_emplace(std::move(key)).first->second; }
+		template<typename K = key_type>
+		T& at(const typename table::template key_arg<K>& key) {
+			iterator it = this->find(key);
+			if (it == this->end())
+				throw std::out_of_range("flat_hash_map::at");
+			return it->second;
+		}
+		template<typename K = key_type>
+		const T& at(const typename table::template key_arg<K>& key) const {
+			const_iterator it = this->find(key);
+			if (it == this->end())
+				throw std::out_of_range("flat_hash_map::at");
+			return it->second;
+		}
+
+		//modifiers
+		//the mapped value is only built when the key is missing
+		template<typename... Args>
+		std::pair<iterator, bool> try_emplace(const key_type& key, Args&&... args) {
+			return this->emplace_key(key, std::piecewise_construct, std::forward_as_tuple(key),
+				std::forward_as_tuple(std::forward<Args>(args)...));
+		}
+		template<typename... Args>
+		std::pair<iterator, bool> try_emplace(key_type&& key, Args&&... args) {
+			return this->emplace_key(key, std::piecewise_construct, std::forward_as_tuple(std::move(key)),
+				std::forward_as_tuple(std::forward<Args>(args)...));
+		}
+		template<typename M>
+		std::pair<iterator, bool> insert_or_assign(const key_type& key, M&& obj) {
+			std::pair<iterator, bool> r = try_emplace(key, std::forward<M>(obj));
+			if (!r.second)
+				r.first->second = std::forward<M>(obj);
+			return r;
+		}
+		template<typename M>
+		std::pair<iterator, bool> insert_or_assign(key_type&& key, M&& obj) {
+			std::pair<iterator, bool> r = try_emplace(std::move(key), std::forward<M>(obj));
+			if (!r.second)
+				r.first->second = std::forward<M>(obj);
+			return r;
+		}
+	};
+
+	template<typename Key, typename T, typename Hash, typename KeyEqual, typename Alloc>
+	inline void swap(flat_hash_map<Key, T, Hash, KeyEqual, Alloc>& lhs, flat_hash_map<Key, T, Hash, KeyEqual, Alloc>& rhs) noexcept {
+		lhs.swap(rhs);
+	}
+
+}
+
+#endif // !TINYSTL_FLAT_HASH_MAP_H
@@ -0,0 +1,47 @@
+#pragma once
+#ifndef TINYSTL_FLAT_HASH_SET_H
+#define TINYSTL_FLAT_HASH_SET_H
+#include"flat_hash_table.h"
+
+//unordered set stored in one open addressing table, see flat_hash_table.h
+//iterators are constant, an element cannot be changed in place since its hash decides its slot
+
+namespace Tiny_STL {
+
+	template<typename Key>
+	struct __flat_set_policy {
+		typedef Key key_type;
+		typedef Key value_type;
+		enum { constant_iterators = true };
+		static const Key& key(const value_type& value) { return value; }
+	};
+
+
+	template<typename Key, typename Hash = hash<Key>, typename KeyEqual = equal_to<Key>,
+		typename Alloc = allocator<Key>>
+	class flat_hash_set :public __flat_hash_table<__flat_set_policy<Key>, Hash, KeyEqual, Alloc> {
+		typedef __flat_hash_table<__flat_set_policy<Key>, Hash, KeyEqual, Alloc> table;
+	public:
+		typedef typename table::key_type		key_type;
+		typedef typename table::value_type		value_type;
+		typedef typename table::size_type		size_type;
+		typedef typename table::iterator		iterator;
+		typedef typename table::const_iterator	const_iterator;
+
+	public:
+		using table::table;
+		flat_hash_set() { }
+		flat_hash_set& operator=(std::initializer_list<value_type> il) {
+			table::operator=(il);
+			return *this;
+		}
+	};
+
+	template<typename Key, typename Hash, typename KeyEqual, typename Alloc>
+	inline void swap(flat_hash_set<Key, Hash, KeyEqual, Alloc>& lhs, flat_hash_set<Key, Hash, KeyEqual, Alloc>& rhs) noexcept {
+		lhs.swap(rhs);
+	}
+
+}
+
+#endif // !TINYSTL_FLAT_HASH_SET_H
@@ -0,0 +1,736 @@
+#pragma once
+#ifndef TINYSTL_FLAT_HASH_TABLE_H
+#define TINYSTL_FLAT_HASH_TABLE_H
+#include"allocator.h"
+#include"functional.h"
+#include"vector.h"
+#include<cstddef>
+#include<cstdint>
+#include<cstring>
+#include<initializer_list>
+#include<iterator>
+#include<new>
+#include<type_traits>
+#include<utility>
+
+//define TINYSTL_FLAT_HASH_SIMD as 0 to force the portable groups
+#ifndef TINYSTL_FLAT_HASH_SIMD
+#define TINYSTL_FLAT_HASH_SIMD 1
+#endif
+
+#if TINYSTL_FLAT_HASH_SIMD && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#define TINYSTL_FLAT_HASH_SSE2 1
+#include<emmintrin.h>
+#endif
+
+#if defined(_MSC_VER)
+#include<intrin.h>
+#endif
+
+//open addressing hash table in the SwissTable layout, the core of flat_hash_map and flat_hash_set
+//every slot has a control byte: empty, deleted, or the low 7 bits (H2) of the hash of its element
+//lookups start at the group chosen by the high bits (H1) and compare a whole group of control bytes
+//at once, 16 with SSE2 and 8 with the portable word-sized fallback, so that elements are only
+//touched when their H2 matches
+//the capacity is always 2^k - 1, the control array holds a sentinel after the last slot and a copy
+//of the first Width - 1 bytes after that, so a group can be loaded at any slot without wrapping
+
+namespace Tiny_STL {
+
+	namespace __flat_hash {
+
+		typedef int8_t ctrl_t;
+
+		//control byte states, a full slot holds its H2 in 0..127
+		enum ctrl_value : ctrl_t {
+			Empty = -128,		//0b10000000
+			Deleted = -2,		//0b11111110
+			Sentinel = -1		//0b11111111, stops iteration at the end of the table
+		};
+
+		inline bool is_full(ctrl_t c) { return c >= 0; }
+		inline bool is_empty_or_deleted(ctrl_t c) { return c < Sentinel; }
+
+		//what a table with no slots points to: lookups see an empty group, iteration stops at once
+		template<class = void>
+		struct empty_group {
+			static const ctrl_t value[16];
+		};
+		template<class V>
+		const ctrl_t empty_group<V>::value[16] = {
+			Sentinel, Empty, Empty, Empty, Empty, Empty, Empty, Empty,
+			Empty, Empty, Empty, Empty, Empty, Empty, Empty, Empty
+		};
+
+		inline unsigned trailing_zeros(uint64_t x)
+		{
+#if defined(__GNUC__)
+			return static_cast<unsigned>(__builtin_ctzll(x));
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_ARM64))
+			unsigned long r;
+			_BitScanForward64(&r, x);
+			return static_cast<unsigned>(r);
+#else
+			unsigned n = 0;
+			for (; !(x & 1); x >>= 1)
+				++n;
+			return n;
+#endif
+		}
+
+		inline unsigned leading_zeros(uint64_t x)
+		{
+#if defined(__GNUC__)
+			return static_cast<unsigned>(__builtin_clzll(x));
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_ARM64))
+			unsigned long r;
+			_BitScanReverse64(&r, x);
+			return static_cast<unsigned>(63 - r);
+#else
+			unsigned n = 0;
+			for (; !(x & (uint64_t(1) << 63)); x <<= 1)
+				++n;
+			return n;
+#endif
+		}
+
+		//set of slots of a group, one bit per slot every 2^Shift bits
+		//iterating over it yields the slot positions in increasing order
+		template<typename T, int Width, int Shift>
+		class bit_mask {
+		public:
+			explicit bit_mask(T m) :mask(m) { }
+			explicit operator bool() const { return mask != 0; }
+			//slots before the lowest set one, the mask must not be empty
+			unsigned trailing() const { return trailing_zeros(mask) >> Shift; }
+			//slots after the highest set one, the mask must not be empty
+			unsigned leading() const { return (leading_zeros(mask) - (64 - (Width << Shift))) >> Shift; }
+
+			unsigned operator*() const { return trailing(); }
+			bit_mask& operator++() {
+				mask &= mask - 1;
+				return *this;
+			}
+			bit_mask begin() const { return *this; }
+			bit_mask end() const { return bit_mask(0); }
+			friend bool operator!=(const bit_mask& lhs, const bit_mask& rhs) { return lhs.mask != rhs.mask; }
+
+		private:
+			T mask;
+		};
+
+#if defined(TINYSTL_FLAT_HASH_SSE2)
+		struct group {
+			enum { Width = 16 };
+			typedef bit_mask<uint32_t, Width, 0> mask_type;
+
+			explicit group(const ctrl_t* p) :ctrl(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p))) { }
+
+			mask_type match(ctrl_t h2) const {
+				return mask_type(static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(h2), ctrl))));
+			}
+			mask_type match_empty() const {
+				return mask_type(static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(Empty), ctrl))));
+			}
+			mask_type match_empty_or_deleted() const {
+				return mask_type(static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpgt_epi8(_mm_set1_epi8(Sentinel), ctrl))));
+			}
+			//length of the run of empty or deleted slots the group starts with
+			unsigned count_leading_empty_or_deleted() const {
+				uint32_t m = static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpgt_epi8(_mm_set1_epi8(Sentinel), ctrl)));
+				return trailing_zeros(m + 1);
+			}
+
+			__m128i ctrl;
+		};
+#else
+		//8 control bytes in a word, the high bit of each byte says whether the slot matched
+		struct group {
+			enum { Width = 8 };
+			typedef bit_mask<uint64_t, Width, 3> mask_type;
+
+			explicit group(const ctrl_t* p) {
+				memcpy(&ctrl, p, sizeof(ctrl));
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+				ctrl = __builtin_bswap64(ctrl);
+#endif
+			}
+
+			//may report a false positive right after a true one, it is always a full slot
+			//and the key comparison rejects it
+			mask_type match(ctrl_t h2) const {
+				const uint64_t lsbs = 0x0101010101010101ull, msbs = 0x8080808080808080ull;
+				uint64_t x = ctrl ^ (lsbs * static_cast<uint8_t>(h2));
+				return mask_type((x - lsbs) & ~x & msbs);
+			}
+			//empty is the only state with the high bit set and bit 1 clear
+			mask_type match_empty() const {
+				return mask_type((ctrl & (~ctrl << 6)) & 0x8080808080808080ull);
+			}
+			//empty and deleted are the states with the high bit set and bit 0 clear
+			mask_type match_empty_or_deleted() const {
+				return mask_type((ctrl & (~ctrl << 7)) & 0x8080808080808080ull);
+			}
+			unsigned count_leading_empty_or_deleted() const {
+				const uint64_t gaps = 0x00fefefefefefefeull;
+				return (trailing_zeros(((~ctrl & (ctrl >> 7)) | gaps) + 1) + 7) >> 3;
+			}
+
+			uint64_t ctrl;
+		};
+#endif
+
+		//triangular probing over groups, visits every group of a power-of-two table once
+		struct probe_seq {
+			probe_seq(size_t hash, size_t m) :mask(m), offset(hash & m), index(0) { }
+			size_t at(size_t i) const { return (offset + i) & mask; }
+			void next() {
+				index += group::Width;
+				offset = (offset + index) & mask;
+			}
+
+			size_t mask;
+			size_t offset;
+			size_t index;
+		};
+
+		//find and erase take any key type when both the hasher and the comparator declare is_transparent
+		template<typename T, typename = void>
+		struct is_transparent :std::false_type { };
+
+		template<typename T>
+		struct is_transparent<T, typename std::conditional<true, void, typename T::is_transparent>::type>
+			:std::true_type { };
+
+		template<bool Transparent>
+		struct key_arg {
+			template<typename K, typename Key>
+			using type = Key;
+		};
+
+		template<>
+		struct key_arg<true> {
+			template<typename K, typename Key>
+			using type = K;
+		};
+	}
+
+
+	template<typename V, bool Const>
+	class __flat_hash_iterator {
+		template<typename, typename, typename, typename> friend class __flat_hash_table;
+		template<typename, bool> friend class __flat_hash_iterator;
+		typedef __flat_hash::ctrl_t ctrl_t;
+	public:
+		typedef std::forward_iterator_tag								iterator_category;
+		typedef V														value_type;
+		typedef ptrdiff_t												difference_type;
+		typedef typename std::conditional<Const, const V*, V*>::type	pointer;
+		typedef typename std::conditional<Const, const V&, V&>::type	reference;
+
+		__flat_hash_iterator() :ctrl(nullptr), slot(nullptr) { }
+		template<bool C, typename = typename std::enable_if<Const && !C>::type>
+		__flat_hash_iterator(const __flat_hash_iterator<V, C>& rhs) :ctrl(rhs.ctrl), slot(rhs.slot) { }
+
+		reference operator*() const { return *slot; }
+		pointer operator->() const { return slot; }
+		__flat_hash_iterator& operator++() {
+			++ctrl;
+			++slot;
+			skip_empty_or_deleted();
+			return *this;
+		}
+		__flat_hash_iterator operator++(int) {
+			__flat_hash_iterator tmp = *this;
+			++*this;
+			return tmp;
+		}
+		friend bool operator==(const __flat_hash_iterator& lhs, const __flat_hash_iterator& rhs) { return lhs.ctrl == rhs.ctrl; }
+		friend bool operator!=(const __flat_hash_iterator& lhs, const __flat_hash_iterator& rhs) { return lhs.ctrl != rhs.ctrl; }
+
+	private:
+		__flat_hash_iterator(ctrl_t* c, V* s) :ctrl(c), slot(s) { }
+		//the sentinel is neither empty nor deleted, so this stops at end()
+		void skip_empty_or_deleted() {
+			while (__flat_hash::is_empty_or_deleted(*ctrl)) {
+				unsigned n = __flat_hash::group(ctrl).count_leading_empty_or_deleted();
+				ctrl += n;
+				slot += n;
+			}
+		}
+
+		ctrl_t* ctrl;
+		V* slot;
+	};
+
+
+	//Policy gives key_type, value_type, key(value) and whether iterators are constant
+	//elements are relocated when the table grows, their move constructors are expected not to throw
+	template<typename Policy, typename Hash, typename KeyEqual, typename Alloc>
+	class __flat_hash_table {
+		typedef __flat_hash::ctrl_t ctrl_t;
+		typedef __flat_hash::group group;
+		typedef __flat_hash::probe_seq probe_seq;
+	public:
+		typedef typename Policy::key_type								key_type;
+		typedef typename Policy::value_type								value_type;
+		typedef Hash													hasher;
+		typedef KeyEqual												key_equal;
+		typedef Alloc													allocator_type;
+		typedef value_type&												reference;
+		typedef const value_type&										const_reference;
+		typedef value_type*												pointer;
+		typedef const value_type*										const_pointer;
+		typedef size_t													size_type;
+		typedef ptrdiff_t												difference_type;
+		typedef __flat_hash_iterator<value_type, Policy::constant_iterators>	iterator;
+		typedef __flat_hash_iterator<value_type, true>					const_iterator;
+
+	protected:
+		template<typename K>
+		using key_arg = typename __flat_hash::key_arg<__flat_hash::is_transparent<Hash>::value &&
+			__flat_hash::is_transparent<KeyEqual>::value>::template type<K, key_type>;
+
+	private:
+		//erase(iterator) has to be an exact match, or a transparent erase(key) would take iterators,
+		//but with constant iterators it would repeat erase(const_iterator)
+		struct __not_an_iterator { };
+		typedef typename std::conditional<Policy::constant_iterators, __not_an_iterator, iterator>::type mutable_iterator;
+
+		typedef Alloc data_allocator;
+		typedef allocator<ctrl_t> ctrl_allocator;
+
+		ctrl_t* ctrl;
+		value_type* slots;
+		size_type num_elements;
+		size_type cap;
+		size_type growth_left;
+		hasher hash_fn;
+		key_equal eq_fn;
+
+	public:
+		//constructors, a table with no elements allocates nothing
+		__flat_hash_table() :__flat_hash_table(0) { }
+		explicit __flat_hash_table(size_type bucket_count, const hasher& hf = hasher(), const key_equal& eq = key_equal())
+			:ctrl(empty_ctrl()), slots(nullptr), num_elements(0), cap(0), growth_left(0), hash_fn(hf), eq_fn(eq) {
+			if (bucket_count)
+				resize(normalize_capacity(bucket_count));
+		}
+		template<typename InputIterator>
+		__flat_hash_table(InputIterator first, InputIterator last, size_type bucket_count = 0,
+			const hasher& hf = hasher(), const key_equal& eq = key_equal()) :__flat_hash_table(bucket_count, hf, eq) {
+			insert(first, last);
+		}
+		__flat_hash_table(std::initializer_list<value_type> il, size_type bucket_count = 0,
+			const hasher& hf = hasher(), const key_equal& eq = key_equal()) :__flat_hash_table(bucket_count, hf, eq) {
+			insert(il.begin(), il.end());
+		}
+		__flat_hash_table(const __flat_hash_table& rhs) :__flat_hash_table(0, rhs.hash_fn, rhs.eq_fn) {
+			reserve(rhs.num_elements);
+			//the keys are known to be distinct, no lookup is needed
+			for (const_iterator it = rhs.begin(); it != rhs.end(); ++it) {
+				size_t h = hash_of(Policy::key(*it));
+				size_type i = find_first_non_full(h);
+				data_allocator::construct(slots + i, *it);
+				set_ctrl(i, H2(h));
+				++num_elements;
+				--growth_left;
+			}
+		}
+		__flat_hash_table(__flat_hash_table&& rhs) noexcept
+			:ctrl(rhs.ctrl), slots(rhs.slots), num_elements(rhs.num_elements), cap(rhs.cap), growth_left(rhs.growth_left),
+			hash_fn(rhs.hash_fn), eq_fn(rhs.eq_fn) {
+			rhs.reset();
+		}
+		__flat_hash_table& operator=(const __flat_hash_table& rhs) {
+			if (this != &rhs) {
+				__flat_hash_table tmp(rhs);
+				swap(tmp);
+			}
+			return *this;
+		}
+		__flat_hash_table& operator=(__flat_hash_table&& rhs) noexcept {
+			if (this != &rhs) {
+				release();
+				ctrl = rhs.ctrl;
+				slots = rhs.slots;
+				num_elements = rhs.num_elements;
+				cap = rhs.cap;
+				growth_left = rhs.growth_left;
+				hash_fn = rhs.hash_fn;
+				eq_fn = rhs.eq_fn;
+				rhs.reset();
+			}
+			return *this;
+		}
+		__flat_hash_table& operator=(std::initializer_list<value_type> il) {
+			clear();
+			insert(il.begin(), il.end());
+			return *this;
+		}
+		~__flat_hash_table() { release(); }
+
+	public:
+		//iterators
+		iterator begin() noexcept {
+			iterator it(ctrl, slots);
+			it.skip_empty_or_deleted();
+			return it;
+		}
+		const_iterator begin() const noexcept { return const_cast<__flat_hash_table*>(this)->begin(); }
+		const_iterator cbegin() const noexcept { return begin(); }
+		iterator end() noexcept { return iterator(ctrl + cap, slots + cap); }
+		const_iterator end() const noexcept { return const_cast<__flat_hash_table*>(this)->end(); }
+		const_iterator cend() const noexcept { return end(); }
+
+		//capacity
+		bool empty() const noexcept { return num_elements == 0; }
+		size_type size() const noexcept { return num_elements; }
+		size_type max_size() const noexcept { return size_type(-1) / sizeof(value_type); }
+		//elements the table can hold before it has to grow
+		size_type capacity() const noexcept { return num_elements + growth_left; }
+		size_type bucket_count() const noexcept { return cap; }
+		float load_factor() const noexcept { return cap ? static_cast<float>(num_elements) / cap : 0.0f; }
+		//fixed at 7/8, setting it has no effect
+		float max_load_factor() const noexcept { return 0.875f; }
+		void max_load_factor(float) noexcept { }
+		void reserve(size_type n) {
+			if (n > num_elements + growth_left)
+				resize(normalize_capacity(growth_to_capacity(n)));
+		}
+		void rehash(size_type n) {
+			if (n == 0 && num_elements == 0) {
+				release();
+				reset();
+				return;
+			}
+			size_type want = normalize_capacity(n);
+			if (num_elements) {
+				size_type need = normalize_capacity(growth_to_capacity(num_elements));
+				want = want < need ? need : want;
+			}
+			if (want != cap)
+				resize(want);
+		}
+
+		//modifiers
+		std::pair<iterator, bool> insert(const value_type& value) { return emplace_key(Policy::key(value), value); }
+		std::pair<iterator, bool> insert(value_type&& value) { return emplace_key(Policy::key(value), std::move(value)); }
+		iterator insert(const_iterator, const value_type& value) { return insert(value).first; }
+		iterator insert(const_iterator, value_type&& value) { return insert(std::move(value)).first; }
+		template<typename InputIterator>
+		void insert(InputIterator first, InputIterator last) {
+			for (; first != last; ++first)
+				insert(*first);
+		}
+		void insert(std::initializer_list<value_type> il) { insert(il.begin(), il.end()); }
+		//the element is built first since its key is only known afterwards
+		template<typename... Args>
+		std::pair<iterator, bool> emplace(Args&&... args) {
+			value_type tmp(std::forward<Args>(args)...);
+			return insert(std::move(tmp));
+		}
+		template<typename... Args>
+		iterator emplace_hint(const_iterator, Args&&... args) { return emplace(std::forward<Args>(args)...).first; }
+
+		//erasing never moves other elements, iterators to them stay valid
+		iterator erase(const_iterator pos) {
+			size_type i = static_cast<size_type>(pos.ctrl - ctrl);
+			data_allocator::destroy(slots + i);
+			erase_meta(i);
+			iterator next(ctrl + i, slots + i);
+			++next;
+			return next;
+		}
+		iterator erase(mutable_iterator pos) { return erase(const_iterator(pos)); }
+		iterator erase(const_iterator first, const_iterator last) {
+			while (first != last)
+				first = erase(first);
+			return iterator(last.ctrl, last.slot);
+		}
+		template<typename K = key_type>
+		size_type erase(const key_arg<K>& key) { return erase<K>(key, hash_fn(key)); }
+		//keeps the slots for reuse
+		void clear() noexcept {
+			if (cap == 0)
+				return;
+			destroy_slots();
+			memset(ctrl, __flat_hash::Empty, cap + group::Width);
+			ctrl[cap] = __flat_hash::Sentinel;
+			num_elements = 0;
+			growth_left = capacity_to_growth(cap);
+		}
+		void swap(__flat_hash_table& rhs) noexcept {
+			std::swap(ctrl, rhs.ctrl);
+			std::swap(slots, rhs.slots);
+			std::swap(num_elements, rhs.num_elements);
+			std::swap(cap, rhs.cap);
+			std::swap(growth_left, rhs.growth_left);
+			std::swap(hash_fn, rhs.hash_fn);
+			std::swap(eq_fn, rhs.eq_fn);
+		}
+
+		//lookup
+		template<typename K = key_type>
+		iterator find(const key_arg<K>& key) { return iterator_at(find_index(key, hash_of(key))); }
+		template<typename K = key_type>
+		const_iterator find(const key_arg<K>& key) const { return const_cast<__flat_hash_table*>(this)->find(key); }
+		template<typename K = key_type>
+		bool contains(const key_arg<K>& key) const { return find_index(key, hash_of(key)) != cap; }
+		template<typename K = key_type>
+		size_type count(const key_arg<K>& key) const { return contains(key) ? 1 : 0; }
+		template<typename K = key_type>
+		std::pair<iterator, iterator> equal_range(const key_arg<K>& key) {
+			iterator it = find(key);
+			if (it == end())
+				return std::pair<iterator, iterator>(it, it);
+			iterator next = it;
+			return std::pair<iterator, iterator>(it, ++next);
+		}
+		template<typename K = key_type>
+		std::pair<const_iterator, const_iterator> equal_range(const key_arg<K>& key) const {
+			std::pair<iterator, iterator> r = const_cast<__flat_hash_table*>(this)->equal_range(key);
+			return std::pair<const_iterator, const_iterator>(r.first, r.second);
+		}
+
+		//the same for callers that already ran hash_function() on the key, hash is its result
+		//concurrent_hash_map hashes a key once, for the shard and for the table inside it
+		template<typename K = key_type>
+		iterator find(const key_arg<K>& key, size_t hash) { return iterator_at(find_index(key, mixed(hash))); }
+		template<typename K = key_type>
+		const_iterator find(const key_arg<K>& key, size_t hash) const {
+			return const_cast<__flat_hash_table*>(this)->find(key, hash);
+		}
+		template<typename K = key_type>
+		bool contains(const key_arg<K>& key, size_t hash) const { return find_index(key, mixed(hash)) != cap; }
+		template<typename K = key_type>
+		size_type erase(const key_arg<K>& key, size_t hash) {
+			size_type i = find_index(key, mixed(hash));
+			if (i == cap)
+				return 0;
+			data_allocator::destroy(slots + i);
+			erase_meta(i);
+			return 1;
+		}
+		//builds value_type(args...) when key is missing, key must be the key of that value
+		template<typename K, typename... Args>
+		std::pair<iterator, bool> emplace_hashed(size_t hash, const K& key, Args&&... args) {
+			return emplace_at(mixed(hash), key, std::forward<Args>(args)...);
+		}
+
+		hasher hash_function() const { return hash_fn; }
+		key_equal key_eq() const { return eq_fn; }
+		allocator_type get_allocator() const { return allocator_type(); }
+
+	protected:
+		//look key up and build value_type(args...) in a new slot when it is missing
+		template<typename K, typename... Args>
+		std::pair<iterator, bool> emplace_key(const K& key, Args&&... args) {
+			return emplace_at(hash_of(key), key, std::forward<Args>(args)...);
+		}
+
+	private:
+		template<typename K, typename... Args>
+		std::pair<iterator, bool> emplace_at(size_t h, const K& key, Args&&... args) {
+			size_type i = find_index(key, h);
+			if (i != cap)
+				return std::pair<iterator, bool>(iterator_at(i), false);
+			i = prepare_insert(h);
+			try {
+				data_allocator::construct(slots + i, std::forward<Args>(args)...);
+			}
+			catch (...) {
+				erase_meta(i);
+				throw;
+			}
+			return std::pair<iterator, bool>(iterator_at(i), true);
+		}
+
+		static ctrl_t* empty_ctrl() { return const_cast<ctrl_t*>(__flat_hash::empty_group<>::value); }
+
+		//hashes that are not known to be well mixed go through hash_mix, H1 and H2 need every bit
+		template<typename K>
+		size_t hash_of(const K& key) const { return mixed(hash_fn(key)); }
+		static size_t mixed(size_t h) { return mix(h, is_avalanching<hasher>()); }
+		static size_t mix(size_t h, std::true_type) { return h; }
+		static size_t mix(size_t h, std::false_type) { return static_cast<size_t>(hash_mix(h)); }
+		static size_t H1(size_t h) { return h >> 7; }
+		static ctrl_t H2(size_t h) { return static_cast<ctrl_t>(h & 0x7f); }
+
+		//7/8 of the slots may be used, a table of 7 slots with 8-wide groups keeps one empty
+		static size_type capacity_to_growth(size_type c) {
+			return (group::Width == 8 && c == 7) ? 6 : c - c / 8;
+		}
+		static size_type growth_to_capacity(size_type g) {
+			return (group::Width == 8 && g == 7) ? 8 : g + (g - 1) / 7;
+		}
+		//smallest 2^k - 1 not below n
+		static size_type normalize_capacity(size_type n) {
+			return n ? static_cast<size_type>(~uint64_t(0) >> __flat_hash::leading_zeros(n)) : 1;
+		}
+
+		iterator iterator_at(size_type i) { return iterator(ctrl + i, slots + i); }
+
+		//writes the control byte and its copy past the sentinel
+		void set_ctrl(size_type i, ctrl_t h) {
+			ctrl[i] = h;
+			ctrl[((i - (group::Width - 1)) & cap) + ((group::Width - 1) & cap)] = h;
+		}
+
+		//index of the slot holding key, cap if there is none
+		template<typename K>
+		size_type find_index(const K& key, size_t h) const {
+			probe_seq seq(H1(h), cap);
+			for (;;) {
+				group g(ctrl + seq.offset);
+				for (unsigned i : g.match(H2(h))) {
+					size_type idx = seq.at(i);
+					if (eq_fn(Policy::key(slots[idx]), key))
+						return idx;
+				}
+				if (g.match_empty())
+					return cap;
+				seq.next();
+			}
+		}
+
+		//first empty or deleted slot on the probe sequence of h
+		size_type find_first_non_full(size_t h) const {
+			probe_seq seq(H1(h), cap);
+			for (;;) {
+				group::mask_type m = group(ctrl + seq.offset).match_empty_or_deleted();
+				if (m)
+					return seq.at(m.trailing());
+				seq.next();
+			}
+		}
+
+		//claims a slot for a new element with hash h, the caller constructs it
+		size_type prepare_insert(size_t h) {
+			size_type i = find_first_non_full(h);
+			if (growth_left == 0 && ctrl[i] != __flat_hash::Deleted) {
+				rehash_and_grow();
+				i = find_first_non_full(h);
+			}
+			growth_left -= (ctrl[i] == __flat_hash::Empty);
+			set_ctrl(i, H2(h));
+			++num_elements;
+			return i;
+		}
+
+		//a slot goes back to empty when no group around it was ever full, as no probe sequence can
+		//have passed over it then; otherwise it becomes a tombstone, dropped at the next rehash
+		void erase_meta(size_type i) {
+			--num_elements;
+			bool never_full = cap < static_cast<size_type>(group::Width);
+			if (!never_full) {
+				group::mask_type empty_before = group(ctrl + ((i - group::Width) & cap)).match_empty();
+				group::mask_type empty_after = group(ctrl + i).match_empty();
+				never_full = empty_before && empty_after &&
+					empty_after.trailing() + empty_before.leading() < static_cast<unsigned>(group::Width);
+			}
+			set_ctrl(i, never_full ? __flat_hash::Empty : __flat_hash::Deleted);
+			growth_left += never_full;
+		}
+
+		//a table mostly made of tombstones is rebuilt at the same size instead of doubling
+		void rehash_and_grow() {
+			if (cap == 0)
+				resize(1);
+			else if (cap > static_cast<size_type>(group::Width) && num_elements * 32 <= cap * 25)
+				resize(cap);
+			else
+				resize(cap * 2 + 1);
+		}
+
+		void resize(size_type new_cap) {
+			ctrl_t* old_ctrl = ctrl;
+			value_type* old_slots = slots;
+			size_type old_cap = cap;
+
+			ctrl_t* new_ctrl = ctrl_allocator::allocate(new_cap + group::Width);
+			value_type* new_slots;
+			try {
+				new_slots = data_allocator::allocate(new_cap);
+			}
+			catch (...) {
+				ctrl_allocator::deallocate(new_ctrl, new_cap + group::Width);
+				throw;
+			}
+			memset(new_ctrl, __flat_hash::Empty, new_cap + group::Width);
+			new_ctrl[new_cap] = __flat_hash::Sentinel;
+			ctrl = new_ctrl;
+			slots = new_slots;
+			cap = new_cap;
+			growth_left = capacity_to_growth(new_cap) - num_elements;
+
+			for (size_type i = 0; i != old_cap; ++i) {
+				if (__flat_hash::is_full(old_ctrl[i])) {
+					size_t h = hash_of(Policy::key(old_slots[i]));
+					size_type j = find_first_non_full(h);
+					set_ctrl(j, H2(h));
+					relocate(slots + j, old_slots + i, is_trivially_relocatable<value_type>());
+				}
+			}
+			if (old_cap) {
+				ctrl_allocator::deallocate(old_ctrl, old_cap + group::Width);
+				data_allocator::deallocate(old_slots, old_cap);
+			}
+		}
+
+		static void relocate(value_type* dest, value_type* src, std::true_type) {
+			memcpy(static_cast<void *>(dest), static_cast<const void *>(src), sizeof(value_type));
+		}
+		static void relocate(value_type* dest, value_type* src, std::false_type) {
+			data_allocator::construct(dest, std::move(*src));
+			data_allocator::destroy(src);
+		}
+
+		void destroy_slots() {
+			if (!std::is_trivially_destructible<value_type>::value) {
+				for (size_type i = 0; i != cap; ++i) {
+					if (__flat_hash::is_full(ctrl[i]))
+						data_allocator::destroy(slots + i);
+				}
+			}
+		}
+
+		void release() {
+			if (cap == 0)
+				return;
+			destroy_slots();
+			ctrl_allocator::deallocate(ctrl, cap + group::Width);
+			data_allocator::deallocate(slots, cap);
+		}
+
+		void reset() {
+			ctrl = empty_ctrl();
+			slots = nullptr;
+			num_elements = 0;
+			cap = 0;
+			growth_left = 0;
+		}
+	};
+
+	//tables are equal when they hold the same elements, whatever their layout
+	template<typename Policy, typename Hash, typename KeyEqual, typename Alloc>
+	inline bool operator==(const __flat_hash_table<Policy, Hash, KeyEqual, Alloc>& lhs,
+		const __flat_hash_table<Policy, Hash, KeyEqual, Alloc>& rhs) {
+		if (lhs.size() != rhs.size())
+			return false;
+		for (auto it = lhs.begin(); it != lhs.end(); ++it) {
+			auto other = rhs.find(Policy::key(*it));
+			if (other == rhs.end() || !(*other == *it))
+				return false;
+		}
+		return true;
+	}
+	template<typename Policy, typename Hash, typename KeyEqual, typename Alloc>
+	inline bool operator!=(const __flat_hash_table<Policy, Hash, KeyEqual, Alloc>& lhs,
+		const __flat_hash_table<Policy, Hash, KeyEqual, Alloc>& rhs) {
+		return !(lhs == rhs);
+	}
+
+}
+
+#endif // !TINYSTL_FLAT_HASH_TABLE_H
@@ -1,11 +1,23 @@
 #pragma once
 #ifndef TINYSTL_FUNCTIONAL_H
 #define TINYSTL_FUNCTIONAL_H
+#include"hash_bytes.h"
+#include<array>
+#include<cstdint>
+#include<cstring>
 #include<string>
 #include<numeric>
 #include<vector>
 #include<list>
 #include<deque>
+#include<type_traits>
+
+//定义为1时，整型与指针的hash经过hash_mix，而不是返回值本身
+//低位相同的key(对齐的指针、8的倍数的id)在按掩码取桶的表中会严重冲突
+#ifndef TINYSTL_HASH_MIX_INTEGERS
+#define TINYSTL_HASH_MIX_INTEGERS 0
+#endif
+
 namespace Tiny_STL {
 
 	//unary function object base structure
@@ -75,6 +87,24 @@ namespace Tiny_STL {
 		}
 	};
 	// Function object class for equality comparison
+	template <typename T = void>
+	struct equal_to :public Binary_Func<T, T, bool>
+	{
+		constexpr bool operator()(const T& lhs, const T& rhs)const {
+			return (lhs == rhs);
+		}
+	};
+	// Transparent version, compares any two types that have operator==
+	template <>
+	struct equal_to<void>
+	{
+		typedef void is_transparent;
+		template <typename A, typename B>
+		constexpr bool operator()(const A& lhs, const B& rhs)const {
+			return (lhs == rhs);
+		}
+	};
+	// Function object class for equality comparison
 	template <typename T>
 	struct not_equal :public Binary_Func<T, T, T>
 	{
@@ -189,95 +219,102 @@ namespace Tiny_STL {
 		//特定类型通过偏特化实现
 	};
 
-	//stackoverflow上看到的@Paul Larson的一个hashtable实现函数
-	//性能并不高但是足够简单实用，针对char*和const char*(string)版本
-	size_t Hash_Seq_str(const char* s, size_t seed = 0)
+	//64位finalizer(murmur3 fmix64)，每个输入位以约1/2的概率影响每个输出位
+	inline uint64_t hash_mix(uint64_t x)
 	{
-		size_t HASH = seed;
-		while (*s)
-		{
-			HASH = HASH * 101 + *s++;
-		}
-		return HASH;
+		x ^= x >> 33;
+		x *= 0xff51afd7ed558ccdull;
+		x ^= x >> 33;
+		x *= 0xc4ceb9fe1a85ec53ull;
+		x ^= x >> 33;
+		return x;
 	}
 
-	template <> struct hash<char*>
-	{
-		size_t operator()(const char* s) const { return Hash_Seq_str(s); }
-	};
-
-	template <> struct hash<const char*>
-	{
-		size_t operator()(const char* s) const { return Hash_Seq_str(s); }
-	};
-
-	template <> struct hash<std::string>
-	{
-		size_t operator()(const std::string& str) const { return Hash_Seq_str(str.data()); }
-	};
-	//对于一些基本整型，返回值本身
-	template <> struct hash<bool>
-	{
-		size_t operator()(bool x) const { return static_cast<size_t>(x); }
-	};
-
-	template <> struct hash<char>
-	{
-		size_t operator()(char x) const { return x; }
-	};
-
-	template <> struct hash<unsigned char>
-	{
-		size_t operator()(unsigned char x) const { return x; }
-	};
-
-	template <> struct hash<signed char>
-	{
-		size_t operator()(unsigned char x) const { return x; }
-	};
+	//hash结果已充分混合的hasher定义typedef is_avalanching
+	//容器据此决定是否还需要自己再混合一次
+	template<typename Hash, typename = void>
+	struct is_avalanching :std::false_type { };
 
-	template <> struct hash<short>
-	{
-		size_t operator()(short x) const { return x; }
-	};
+	template<typename Hash>
+	struct is_avalanching<Hash, typename std::conditional<true, void, typename Hash::is_avalanching>::type>
+		:std::true_type { };
 
-	template <> struct hash<unsigned short>
+	//对单个类型开启混合：mixed_hash<T>在Hash的结果上再做hash_mix
+	template<typename T, typename Hash = hash<T>>
+	struct mixed_hash :public Unary_Func<T, size_t>
 	{
-		size_t operator()(unsigned short x) const { return x; }
+		typedef void is_avalanching;
+		size_t operator()(const T& x) const {
+			return static_cast<size_t>(hash_mix(static_cast<uint64_t>(Hash()(x))));
+		}
 	};
 
-	template <> struct hash<int>
+	//C字符串的hash，以strlen得到长度后交给hash_bytes
+	//原先的HASH*101 + c逐字节处理且高位分布很差，已由hash_bytes取代
+	inline size_t Hash_Seq_str(const char* s, size_t seed = 0)
 	{
-		size_t operator()(int x) const { return x; }
-	};
+		return static_cast<size_t>(hash_bytes(s, strlen(s), seed));
+	}
 
-	template <> struct hash<unsigned int>
+	template <> struct hash<char*>
 	{
-		size_t operator()(unsigned int x) const { return x; }
+		typedef void is_avalanching;
+		size_t operator()(const char* s) const { return Hash_Seq_str(s); }
 	};
 
-	template <> struct hash<long>
+	template <> struct hash<const char*>
 	{
-		size_t operator()(long x) const { return x; }
+		typedef void is_avalanching;
+		size_t operator()(const char* s) const { return Hash_Seq_str(s); }
 	};
 
-	template <> struct hash<unsigned long>
+	//按size()计算，不再扫描'\0'，内嵌的'\0'也参与hash
+	//可以直接对C字符串求hash，结果与同内容的string相同，配合equal_to<>用于异构查找
+	template <> struct hash<std::string>
 	{
-		size_t operator()(unsigned long x) const { return x; }
+		typedef void is_avalanching;
+		typedef void is_transparent;
+		size_t operator()(const std::string& str) const {
+			return static_cast<size_t>(hash_bytes(str.data(), str.size()));
+		}
+		size_t operator()(const char* s) const { return Hash_Seq_str(s); }
 	};
 
-	template <> struct hash<long long>
+	//对于一些基本整型，默认返回值本身，TINYSTL_HASH_MIX_INTEGERS为1时经过hash_mix
+	template<typename T, bool = TINYSTL_HASH_MIX_INTEGERS>
+	struct __integral_hash :public Unary_Func<T, size_t>
 	{
-		size_t operator()(long long x) const {
-			return x;
-		}
+		size_t operator()(T x) const { return static_cast<size_t>(x); }
 	};
 
-	template <> struct hash<unsigned long long>
+	template<typename T>
+	struct __integral_hash<T, true> :public Unary_Func<T, size_t>
+	{
+		typedef void is_avalanching;
+		size_t operator()(T x) const { return static_cast<size_t>(hash_mix(static_cast<uint64_t>(x))); }
+	};
+
+	template <> struct hash<bool> :public __integral_hash<bool> { };
+	template <> struct hash<char> :public __integral_hash<char> { };
+	template <> struct hash<unsigned char> :public __integral_hash<unsigned char> { };
+	template <> struct hash<signed char> :public __integral_hash<signed char> { };
+	template <> struct hash<short> :public __integral_hash<short> { };
+	template <> struct hash<unsigned short> :public __integral_hash<unsigned short> { };
+	template <> struct hash<int> :public __integral_hash<int> { };
+	template <> struct hash<unsigned int> :public __integral_hash<unsigned int> { };
+	template <> struct hash<long> :public __integral_hash<long> { };
+	template <> struct hash<unsigned long> :public __integral_hash<unsigned long> { };
+	template <> struct hash<long long> :public __integral_hash<long long> { };
+	template <> struct hash<unsigned long long> :public __integral_hash<unsigned long long> { };
+
+	//指针按地址hash，除char*和const char*外(二者按C字符串处理)
+	template<typename T>
+	struct hash<T*> :public Unary_Func<T*, size_t>
 	{
-		size_t operator()(unsigned long long x) const {
-			return x;
-		}
+#if TINYSTL_HASH_MIX_INTEGERS
+		typedef void is_avalanching;
+#endif
+		size_t operator()(T* p) const { return __integral_hash<uintptr_t>()(reinterpret_cast<uintptr_t>(p)); }
 	};
 
 	//other types，referenced from boost::hash，accomplished by function hash_combine and hash_range
@@ -286,19 +323,39 @@ namespace Tiny_STL {
 		seed ^= hasher(v) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
 	}
 
-	template<typename It> size_t hash_range(It first, It last) {
-		size_t seed = 0;
+	//对象表示与值一一对应的类型：值相等当且仅当字节相同，可以直接按字节hash
+	//默认包括整型、枚举与指针；float/double(+0与-0)以及含padding的类型不满足
+	//自定义类型满足条件时可以特化为true_type
+	template<typename T>
+	struct is_uniquely_represented :std::integral_constant<bool,
+		std::is_integral<T>::value || std::is_enum<T>::value || std::is_pointer<T>::value> { };
+
+	//指向uniquely represented类型的指针区间是连续的字节，交给hash_bytes整块处理
+	template<typename It>
+	struct __is_hashable_bytes :std::false_type { };
+
+	template<typename T>
+	struct __is_hashable_bytes<T*> :is_uniquely_represented<typename std::remove_cv<T>::type> { };
+
+	template<typename It>
+	inline void __hash_range(size_t& seed, It first, It last, std::false_type) {
 		for (; first != last; ++first)
 		{
 			hash_combine(seed, *first);
 		}
+	}
+	template<typename T>
+	inline void __hash_range(size_t& seed, T* first, T* last, std::true_type) {
+		seed = static_cast<size_t>(hash_bytes(first, static_cast<size_t>(last - first) * sizeof(T), seed));
+	}
+
+	template<typename It> size_t hash_range(It first, It last) {
+		size_t seed = 0;
+		__hash_range(seed, first, last, __is_hashable_bytes<It>());
 		return seed;
 	}
 	template<typename It> void hash_range(size_t& seed, It first, It last) {
-		for (; first != last; ++first)
-		{
-			hash_combine(seed, *first);
-		}
+		__hash_range(seed, first, last, __is_hashable_bytes<It>());
 	}
 
 	//overload hash func of two prams
@@ -318,6 +375,15 @@ namespace Tiny_STL {
 	struct hash<std::vector<A, B>> : public Binary_Func<A, B, size_t>
 	{
 		size_t operator()(const std::vector<A, B>& val) const {
+			return hash_range(val.data(), val.data() + val.size());
+		}
+	};
+
+	//vector<bool>按位存储，没有data()
+	template<typename B>
+	struct hash<std::vector<bool, B>> :public Unary_Func<std::vector<bool, B>, size_t>
+	{
+		size_t operator()(const std::vector<bool, B>& val) const {
 			return hash_range(val.begin(), val.end());
 		}
 	};
@@ -339,15 +405,15 @@ namespace Tiny_STL {
 	};
 
 	template<typename A, size_t B>
-	struct hash<std::array<A, B>> :public Binary_Func<A, B, size_t>
+	struct hash<std::array<A, B>> :public Unary_Func<std::array<A, B>, size_t>
 	{
 		size_t operator()(const std::array<A, B>& val) const {
-			return hash_range(val.begin(), val.end());
+			return hash_range(val.data(), val.data() + val.size());
 		}
 	};
 
 	template<typename T, size_t N>
-	struct hash<const T (&)[N]> :public Binary_Func<T, N, size_t>
+	struct hash<const T (&)[N]> :public Unary_Func<const T (&)[N], size_t>
 	{
 		size_t operator()(const T (&val)[N]) const {
 			return hash_range(val, val+N);
@@ -355,7 +421,7 @@ namespace Tiny_STL {
 	}; 
 	
 	template<typename T, size_t N>
-	struct hash<T(&)[N]> :public Binary_Func<T, N, size_t>
+	struct hash<T(&)[N]> :public Unary_Func<T(&)[N], size_t>
 	{
 		size_t operator()(T(&val)[N]) const {
 			return hash_range(val, val + N);
@@ -0,0 +1,286 @@
+#pragma once
+#ifndef TINYSTL_HASH_BYTES_H
+#define TINYSTL_HASH_BYTES_H
+#include<cstddef>
+#include<cstdint>
+#include<cstring>
+
+//hash of a byte sequence, length-aware and seeded
+//short and medium keys take a wyhash-style 128-bit multiply-mix over 16 bytes per step,
+//long keys an xxh3-style stripe accumulator that is vectorized with SSE2/AVX2 when available
+//every path gives the same value on a given byte order, so hashes do not depend on the build flags
+
+//define TINYSTL_HASH_SIMD as 0 to force the scalar accumulator
+#ifndef TINYSTL_HASH_SIMD
+#define TINYSTL_HASH_SIMD 1
+#endif
+
+#if TINYSTL_HASH_SIMD && defined(__AVX2__)
+#define TINYSTL_HASH_AVX2 1
+#include<immintrin.h>
+#elif TINYSTL_HASH_SIMD && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#define TINYSTL_HASH_SSE2 1
+#include<emmintrin.h>
+#endif
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_ARM64))
+#include<intrin.h>
+#endif
+
+namespace Tiny_STL {
+
+	namespace __hash_detail {
+
+		//odd constants with balanced bits, in a template so that the header defines them once
+		template<class = void>
+		struct constants {
+			static constexpr uint64_t secret[4] = {
+				0xa0761d6478bd642full, 0xe7037ed1a0b428dbull, 0x8ebc6af09c88c6e3ull, 0x589965cc75374cc3ull
+			};
+			//one key per accumulator lane of the long path
+			static constexpr uint64_t lane_key[8] = {
+				0x2cb0f69f4abea221ull, 0x9417034723148989ull, 0xdd555950609dfe03ull, 0xdbafb150deb12800ull,
+				0x7e789b2e6c442cb6ull, 0xf41e5636c7e4f8c4ull, 0x0959d150f8fba7e4ull, 0xa97316f13cdb9eeaull
+			};
+		};
+		template<class V> constexpr uint64_t constants<V>::secret[4];
+		template<class V> constexpr uint64_t constants<V>::lane_key[8];
+		typedef constants<> K;
+
+		enum {
+			Stripe = 64,			//bytes consumed by one step of the long path
+			Block_stripes = 16,		//stripes between two scrambles of the accumulators
+			Long_threshold = 1024	//keys longer than this take the long path
+		};
+
+		//full 64x64 -> 128 product, folded back to 64 bits
+		inline uint64_t mix(uint64_t a, uint64_t b)
+		{
+#if defined(__SIZEOF_INT128__)
+			__uint128_t r = static_cast<__uint128_t>(a) * b;
+			return static_cast<uint64_t>(r) ^ static_cast<uint64_t>(r >> 64);
+#elif defined(_MSC_VER) && defined(_M_X64)
+			uint64_t hi;
+			uint64_t lo = _umul128(a, b, &hi);
+			return lo ^ hi;
+#elif defined(_MSC_VER) && defined(_M_ARM64)
+			return (a * b) ^ __umulh(a, b);
+#else
+			uint64_t ha = a >> 32, hb = b >> 32, la = static_cast<uint32_t>(a), lb = static_cast<uint32_t>(b);
+			uint64_t rh = ha * hb, rm0 = ha * lb, rm1 = hb * la, rl = la * lb;
+			uint64_t t = rl + (rm0 << 32);
+			uint64_t c = t < rl;
+			uint64_t lo = t + (rm1 << 32);
+			c += lo < t;
+			uint64_t hi = rh + (rm0 >> 32) + (rm1 >> 32) + c;
+			return lo ^ hi;
+#endif
+		}
+
+		inline uint64_t read64(const unsigned char* p)
+		{
+			uint64_t v;
+			memcpy(&v, p, sizeof(v));
+			return v;
+		}
+
+		inline uint64_t read32(const unsigned char* p)
+		{
+			uint32_t v;
+			memcpy(&v, p, sizeof(v));
+			return v;
+		}
+
+		//1 to 3 bytes, every byte is read once
+		inline uint64_t read_small(const unsigned char* p, size_t len)
+		{
+			return (static_cast<uint64_t>(p[0]) << 16) | (static_cast<uint64_t>(p[len >> 1]) << 8) | p[len - 1];
+		}
+
+		//one stripe into the eight accumulators:
+		//acc[i] += lo32(d ^ k) * hi32(d ^ k), and the raw data goes to the neighbour lane
+		//so that the multiply never loses input bits
+		inline void accumulate_scalar(uint64_t* acc, const unsigned char* p, const uint64_t* key)
+		{
+			for (int i = 0; i < 8; ++i) {
+				uint64_t d = read64(p + 8 * i);
+				uint64_t k = d ^ key[i];
+				acc[i ^ 1] += d;
+				acc[i] += static_cast<uint32_t>(k) * (k >> 32);
+			}
+		}
+
+		inline void scramble_scalar(uint64_t* acc, const uint64_t* key)
+		{
+			for (int i = 0; i < 8; ++i) {
+				uint64_t a = acc[i];
+				a ^= a >> 47;
+				a ^= key[i];
+				acc[i] = a * 0x9e3779b1u;
+			}
+		}
+
+#if defined(TINYSTL_HASH_AVX2)
+		inline void accumulate_stripes(uint64_t* acc, const unsigned char* p, size_t stripes, const uint64_t* key)
+		{
+			__m256i a[2], k[2];
+			for (int i = 0; i < 2; ++i) {
+				a[i] = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(acc) + i);
+				k[i] = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(key) + i);
+			}
+			for (; stripes > 0; --stripes, p += Stripe) {
+				for (int i = 0; i < 2; ++i) {
+					__m256i d = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p) + i);
+					__m256i x = _mm256_xor_si256(d, k[i]);
+					__m256i prod = _mm256_mul_epu32(x, _mm256_srli_epi64(x, 32));
+					__m256i swapped = _mm256_shuffle_epi32(d, _MM_SHUFFLE(1, 0, 3, 2));
+					a[i] = _mm256_add_epi64(a[i], _mm256_add_epi64(prod, swapped));
+				}
+			}
+			for (int i = 0; i < 2; ++i)
+				_mm256_storeu_si256(reinterpret_cast<__m256i*>(acc) + i, a[i]);
+		}
+
+		inline void scramble(uint64_t* acc, const uint64_t* key)
+		{
+			const __m256i prime = _mm256_set1_epi32(static_cast<int>(0x9e3779b1u));
+			for (int i = 0; i < 2; ++i) {
+				__m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(acc) + i);
+				__m256i k = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(key) + i);
+				a = _mm256_xor_si256(_mm256_xor_si256(a, _mm256_srli_epi64(a, 47)), k);
+				__m256i lo = _mm256_mul_epu32(a, prime);
+				__m256i hi = _mm256_mul_epu32(_mm256_srli_epi64(a, 32), prime);
+				a = _mm256_add_epi64(lo, _mm256_slli_epi64(hi, 32));
+				_mm256_storeu_si256(reinterpret_cast<__m256i*>(acc) + i, a);
+			}
+		}
+#elif defined(TINYSTL_HASH_SSE2)
+		inline void accumulate_stripes(uint64_t* acc, const unsigned char* p, size_t stripes, const uint64_t* key)
+		{
+			__m128i a[4], k[4];
+			for (int i = 0; i < 4; ++i) {
+				a[i] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(acc) + i);
+				k[i] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(key) + i);
+			}
+			for (; stripes > 0; --stripes, p += Stripe) {
+				for (int i = 0; i < 4; ++i) {
+					__m128i d = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p) + i);
+					__m128i x = _mm_xor_si128(d, k[i]);
+					__m128i prod = _mm_mul_epu32(x, _mm_srli_epi64(x, 32));
+					__m128i swapped = _mm_shuffle_epi32(d, _MM_SHUFFLE(1, 0, 3, 2));
+					a[i] = _mm_add_epi64(a[i], _mm_add_epi64(prod, swapped));
+				}
+			}
+			for (int i = 0; i < 4; ++i)
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(acc) + i, a[i]);
+		}
+
+		inline void scramble(uint64_t* acc, const uint64_t* key)
+		{
+			const __m128i prime = _mm_set1_epi32(static_cast<int>(0x9e3779b1u));
+			for (int i = 0; i < 4; ++i) {
+				__m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(acc) + i);
+				__m128i k = _mm_loadu_si128(reinterpret_cast<const __m128i*>(key) + i);
+				a = _mm_xor_si128(_mm_xor_si128(a, _mm_srli_epi64(a, 47)), k);
+				__m128i lo = _mm_mul_epu32(a, prime);
+				__m128i hi = _mm_mul_epu32(_mm_srli_epi64(a, 32), prime);
+				a = _mm_add_epi64(lo, _mm_slli_epi64(hi, 32));
+				_mm_storeu_si128(reinterpret_cast<__m128i*>(acc) + i, a);
+			}
+		}
+#else
+		inline void accumulate_stripes(uint64_t* acc, const unsigned char* p, size_t stripes, const uint64_t* key)
+		{
+			for (; stripes > 0; --stripes, p += Stripe)
+				accumulate_scalar(acc, p, key);
+		}
+
+		inline void scramble(uint64_t* acc, const uint64_t* key)
+		{
+			scramble_scalar(acc, key);
+		}
+#endif
+
+		//keys longer than Long_threshold, len > Stripe is guaranteed
+		inline uint64_t hash_long(const unsigned char* p, size_t len, uint64_t seed)
+		{
+			uint64_t key[8];
+			for (int i = 0; i < 8; ++i)
+				key[i] = K::lane_key[i] + ((i & 1) ? 0 - seed : seed);
+			uint64_t acc[8] = {
+				K::secret[0], K::secret[1], K::secret[2], K::secret[3], K::lane_key[0], K::lane_key[1], K::lane_key[2], K::lane_key[3]
+			};
+
+			const size_t block = Stripe * Block_stripes;
+			const size_t blocks = (len - 1) / block;
+			for (size_t n = 0; n < blocks; ++n, p += block) {
+				accumulate_stripes(acc, p, Block_stripes, key);
+				scramble(acc, key);
+			}
+			//the rest of the last block, then its final stripe again, overlapping what came before
+			size_t rest = len - blocks * block;
+			accumulate_stripes(acc, p, (rest - 1) / Stripe, key);
+			accumulate_scalar(acc, p + rest - Stripe, key);
+
+			uint64_t h = static_cast<uint64_t>(len) * K::secret[0];
+			for (int i = 0; i < 8; i += 2)
+				h += mix(acc[i] ^ K::secret[(i >> 1) & 3], acc[i + 1] ^ seed);
+			return h;
+		}
+
+	}
+
+	//hash len bytes starting at data, embedded zeros included
+	inline uint64_t hash_bytes(const void* data, size_t len, uint64_t seed = 0)
+	{
+		using namespace __hash_detail;
+		const unsigned char* p = static_cast<const unsigned char*>(data);
+		seed ^= mix(seed ^ K::secret[0], K::secret[1]);
+		uint64_t a, b;
+		if (len <= 16) {
+			if (len >= 4) {
+				//two overlapping pairs of 32-bit reads cover 4 to 16 bytes
+				size_t mid = (len >> 3) << 2;
+				a = (read32(p) << 32) | read32(p + mid);
+				b = (read32(p + len - 4) << 32) | read32(p + len - 4 - mid);
+			}
+			else if (len > 0) {
+				a = read_small(p, len);
+				b = 0;
+			}
+			else
+				a = b = 0;
+		}
+		else if (len <= Long_threshold) {
+			size_t i = len;
+			if (i > 48) {
+				uint64_t see1 = seed, see2 = seed;
+				do {
+					seed = mix(read64(p) ^ K::secret[1], read64(p + 8) ^ seed);
+					see1 = mix(read64(p + 16) ^ K::secret[2], read64(p + 24) ^ see1);
+					see2 = mix(read64(p + 32) ^ K::secret[3], read64(p + 40) ^ see2);
+					p += 48;
+					i -= 48;
+				} while (i > 48);
+				seed ^= see1 ^ see2;
+			}
+			while (i > 16) {
+				seed = mix(read64(p) ^ K::secret[1], read64(p + 8) ^ seed);
+				p += 16;
+				i -= 16;
+			}
+			//the last 16 bytes, possibly overlapping the previous step
+			a = read64(p + i - 16);
+			b = read64(p + i - 8);
+		}
+		else {
+			seed = hash_long(p, len, seed);
+			a = read64(p + len - 16);
+			b = read64(p + len - 8);
+		}
+		return mix(K::secret[1] ^ len, mix(a ^ K::secret[1], b ^ seed));
+	}
+
+}
+
+#endif // !TINYSTL_HASH_BYTES_H
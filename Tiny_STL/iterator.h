@@ -1,6 +1,8 @@
 #pragma once
 #ifndef TINYSTL_ITERATOR_H
 #define TINYSTL_ITERATOR_H
+#include<cstddef>
+#include<iterator>
 
 //This head file design for the basic application of iterator
 
@@ -101,7 +103,7 @@ namespace Tiny_STL {
 		typedef T                                     value_type;
 		typedef ptrdiff_t                             difference_type;
 		typedef T*                                    pointer;
-		typedef T&
+		typedef T&                                    reference;
 	};
 
 	template<class T>
@@ -111,7 +113,7 @@ namespace Tiny_STL {
 		typedef T                                     value_type;
 		typedef ptrdiff_t                             difference_type;
 		typedef const T*                              pointer;
-		typedef const T&
+		typedef const T&                              reference;
 	};
 
 	template<class Iterator>
@@ -121,6 +123,25 @@ namespace Tiny_STL {
 		return category();
 	}
 
+	//iterators of the standard library carry std tags, map them onto ours so they dispatch the same way
+	inline input_iterator_tag __to_tag(std::input_iterator_tag) { return input_iterator_tag(); }
+	inline output_iterator_tag __to_tag(std::output_iterator_tag) { return output_iterator_tag(); }
+	inline forward_iterator_tag __to_tag(std::forward_iterator_tag) { return forward_iterator_tag(); }
+	inline bidirectional_iterator_tag __to_tag(std::bidirectional_iterator_tag) { return bidirectional_iterator_tag(); }
+	inline random_access_iterator_tag __to_tag(std::random_access_iterator_tag) { return random_access_iterator_tag(); }
+	inline input_iterator_tag __to_tag(input_iterator_tag) { return input_iterator_tag(); }
+	inline output_iterator_tag __to_tag(output_iterator_tag) { return output_iterator_tag(); }
+	inline forward_iterator_tag __to_tag(forward_iterator_tag) { return forward_iterator_tag(); }
+	inline bidirectional_iterator_tag __to_tag(bidirectional_iterator_tag) { return bidirectional_iterator_tag(); }
+	inline random_access_iterator_tag __to_tag(random_access_iterator_tag) { return random_access_iterator_tag(); }
+
+	//the category of an iterator as one of our tags
+	template<class Iterator>
+	inline auto __category(const Iterator&)
+		-> decltype(Tiny_STL::__to_tag(typename iterator_traits<Iterator>::iterator_category())) {
+		return Tiny_STL::__to_tag(typename iterator_traits<Iterator>::iterator_category());
+	}
+
 	template<class Iterator>
 	inline typename iterator_traits<Iterator>::value_type*
 		value_type(const Iterator& It) {
@@ -159,7 +180,7 @@ namespace Tiny_STL {
 	inline typename iterator_traits<InputIterator>::difference_type
 	distance(InputIterator first, InputIterator last)
 	{
-		return Tiny_STL::__distance(first, last, iterator_category(first));
+		return Tiny_STL::__distance(first, last, Tiny_STL::__category(first));
 	}	
 
 
@@ -188,7 +209,7 @@ namespace Tiny_STL {
 	template <class InputIterator, class Distance>
 	inline void advance(InputIterator& i, Distance n)
 	{
-		Tiny_STL::__advance(i, n, iterator_category(i));
+		Tiny_STL::__advance(i, n, Tiny_STL::__category(i));
 	}
 
 }
@@ -1,7 +1,14 @@
 #pragma once
 #ifndef MEMORY_H
 #define MEMORY_H
-#include<functional>
+#include"allocator.h"
+#include<atomic>
+#include<cassert>
+#include<cstddef>
+#include<cstdint>
+#include<new>
+#include<type_traits>
+#include<utility>
 //include default deleter , unique_ptr and shared_ptr
 
 namespace Tiny_STL {
@@ -27,36 +34,110 @@ namespace Tiny_STL {
 		}
 	};
 
+	//deleter for objects made with allocator<T>: destroys and hands the memory back to alloc
+	template<typename T>
+	class allocator_delete
+	{
+	public:
+		void operator()(T* t)const {
+			if (t) {
+				allocator<T>::destroy(t);
+				allocator<T>::deallocate(t);
+			}
+		}
+	};
+
+	//pointer and deleter of unique_ptr
+	//an empty deleter such as default_delete is a base class instead of a member, so it takes no room
+	template<typename T, typename D, bool = std::is_empty<D>::value && !std::is_final<D>::value>
+	class __unique_ptr_storage : private D
+	{
+	public:
+		__unique_ptr_storage() noexcept : D(), ptr(nullptr) { }
+		template<typename E>
+		__unique_ptr_storage(T* p, E&& d) noexcept : D(std::forward<E>(d)), ptr(p) { }
+
+		D& deleter() noexcept { return *this; }
+		const D& deleter() const noexcept { return *this; }
+
+		T* ptr;
+	};
+	template<typename T, typename D>
+	class __unique_ptr_storage<T, D, false>
+	{
+	public:
+		__unique_ptr_storage() noexcept : ptr(nullptr), del() { }
+		template<typename E>
+		__unique_ptr_storage(T* p, E&& d) noexcept : ptr(p), del(std::forward<E>(d)) { }
+
+		D& deleter() noexcept { return del; }
+		const D& deleter() const noexcept { return del; }
+
+		T* ptr;
+	private:
+		D del;
+	};
+
 	//declaration of unique_ptr and .swap()
-	template<typename, typename> class unique_ptr;
+	template<typename T, typename D = default_delete<T>> class unique_ptr;
 	template<typename T, typename D>
-	void swap(unique_ptr<T, D>& lhs, unique_ptr<T, D>& rhs);
+	void swap(unique_ptr<T, D>& lhs, unique_ptr<T, D>& rhs) noexcept;
 
+	//make_unique<T>(args...) for an object, make_unique<T[]>(n) for n value-initialized elements
 	template <typename T, typename... Args>
-	unique_ptr<T> make_unique(Args&&... args) {
+	typename std::enable_if<!std::is_array<T>::value, unique_ptr<T>>::type
+		make_unique(Args&&... args) {
 		return unique_ptr<T>(new T(std::forward<Args>(args)...));
-	};
+	}
+	template <typename T>
+	typename std::enable_if<std::is_array<T>::value && std::extent<T>::value == 0, unique_ptr<T>>::type
+		make_unique(size_t n) {
+		return unique_ptr<T>(new typename std::remove_extent<T>::type[n]());
+	}
+	template <typename T, typename... Args>
+	typename std::enable_if<std::extent<T>::value != 0>::type
+		make_unique(Args&&...) = delete;
+
+	//same as make_unique but default-initialized: a buffer of trivial elements is left as it is
+	//instead of being zeroed, for memory that is about to be overwritten anyway
+	template <typename T>
+	typename std::enable_if<!std::is_array<T>::value, unique_ptr<T>>::type
+		make_unique_for_overwrite() {
+		return unique_ptr<T>(new T);
+	}
+	template <typename T>
+	typename std::enable_if<std::is_array<T>::value && std::extent<T>::value == 0, unique_ptr<T>>::type
+		make_unique_for_overwrite(size_t n) {
+		return unique_ptr<T>(new typename std::remove_extent<T>::type[n]);
+	}
+	template <typename T, typename... Args>
+	typename std::enable_if<std::extent<T>::value != 0>::type
+		make_unique_for_overwrite(Args&&...) = delete;
 
 
-	template <typename T, typename D = default_delete<T>>
+	template <typename T, typename D>
 	class unique_ptr
 	{
-		friend void Tiny_STL::swap<T, D>(unique_ptr<T, D>& lhs, unique_ptr<T, D>& rhs);
+		friend void Tiny_STL::swap<T, D>(unique_ptr<T, D>& lhs, unique_ptr<T, D>& rhs) noexcept;
 
 	public:
+		typedef T	element_type;
+		typedef D	deleter_type;
+		typedef T*	pointer;
+
 		// preventing copy and assignment
 		unique_ptr(const unique_ptr&) = delete;
 		unique_ptr& operator = (const unique_ptr&) = delete;
 
-		// default constructor and one taking T*
-		unique_ptr() = default;
-		explicit unique_ptr(T* up) : ptr(up) { }
+		// default constructor and one taking T*, with an optional deleter
+		constexpr unique_ptr() noexcept { }
+		constexpr unique_ptr(std::nullptr_t) noexcept { }
+		explicit unique_ptr(T* up) noexcept : impl(up, D()) { }
+		unique_ptr(T* up, const D& d) noexcept : impl(up, d) { }
 
-		// move constructor
+		// move constructor, takes the deleter along
 		unique_ptr(unique_ptr&& up) noexcept
-			: ptr(up.ptr) {
-			up.ptr = nullptr;
-		}
+			: impl(up.release(), std::forward<D>(up.get_deleter())) { }
 
 		// move assignment
 		unique_ptr& operator =(unique_ptr&& rhs) noexcept;
@@ -67,57 +148,125 @@ namespace Tiny_STL {
 
 
 		// operator overloaded :  *  ->  bool
-		T& operator  *() const { return *ptr; }
-		T* operator ->() const { return &this->operator *(); }
-		operator bool() const { return ptr ? true : false; }
+		T& operator  *() const { return *impl.ptr; }
+		T* operator ->() const { return impl.ptr; }
+		operator bool() const { return impl.ptr ? true : false; }
 
 		// return the underlying pointer
-		T* get() const noexcept { return ptr; }
+		T* get() const noexcept { return impl.ptr; }
 
 		// swap member using swap friend
-		void swap(unique_ptr<T, D> &rhs) { ::swap(*this, rhs); }
+		void swap(unique_ptr<T, D> &rhs) noexcept { Tiny_STL::swap(*this, rhs); }
 
 		// free and make it point to nullptr or to p's pointee.
-		void reset()     noexcept { deleter(ptr); ptr = nullptr; }
-		void reset(T* p) noexcept { deleter(ptr); ptr = p; }
+		void reset(T* p = nullptr) noexcept;
 
 		// return ptr and make ptr point to nullptr.
-		T* release();
+		T* release() noexcept;
 
-		D&  get_deleter() { return deleter; }
+		D&  get_deleter() noexcept { return impl.deleter(); }
+		const D&  get_deleter() const noexcept { return impl.deleter(); }
 
 		~unique_ptr()
 		{
-			deleter(ptr);
+			static_assert(!std::is_empty<D>::value || std::is_final<D>::value || sizeof(unique_ptr) == sizeof(T*),
+				"unique_ptr with an empty deleter must stay one pointer wide");
+			if (impl.ptr)
+				impl.deleter()(impl.ptr);
 		}
 	private:
-		T* ptr = nullptr;
-		D  deleter = D();
+		__unique_ptr_storage<T, D> impl;
+	};
+
+
+	//unique_ptr for arrays made with new[], default_delete<T[]> calls delete[]
+	//no * and ->, elements are reached through []
+	template <typename T, typename D>
+	class unique_ptr<T[], D>
+	{
+		friend void Tiny_STL::swap<T[], D>(unique_ptr<T[], D>& lhs, unique_ptr<T[], D>& rhs) noexcept;
+
+	public:
+		typedef T	element_type;
+		typedef D	deleter_type;
+		typedef T*	pointer;
+
+		unique_ptr(const unique_ptr&) = delete;
+		unique_ptr& operator = (const unique_ptr&) = delete;
+
+		constexpr unique_ptr() noexcept { }
+		constexpr unique_ptr(std::nullptr_t) noexcept { }
+		explicit unique_ptr(T* up) noexcept : impl(up, D()) { }
+		unique_ptr(T* up, const D& d) noexcept : impl(up, d) { }
+
+		unique_ptr(unique_ptr&& up) noexcept
+			: impl(up.release(), std::forward<D>(up.get_deleter())) { }
+
+		unique_ptr& operator =(unique_ptr&& rhs) noexcept
+		{
+			reset(rhs.release());
+			impl.deleter() = std::forward<D>(rhs.get_deleter());
+			return *this;
+		}
+		unique_ptr& operator =(std::nullptr_t) noexcept
+		{
+			reset();
+			return *this;
+		}
+
+		T& operator [](size_t i) const { return impl.ptr[i]; }
+		operator bool() const { return impl.ptr ? true : false; }
+
+		T* get() const noexcept { return impl.ptr; }
+
+		void swap(unique_ptr &rhs) noexcept { Tiny_STL::swap(*this, rhs); }
+
+		void reset(T* p = nullptr) noexcept
+		{
+			T* old = impl.ptr;
+			impl.ptr = p;
+			if (old)
+				impl.deleter()(old);
+		}
+
+		T* release() noexcept
+		{
+			T* ret = impl.ptr;
+			impl.ptr = nullptr;
+			return ret;
+		}
+
+		D&  get_deleter() noexcept { return impl.deleter(); }
+		const D&  get_deleter() const noexcept { return impl.deleter(); }
+
+		~unique_ptr()
+		{
+			if (impl.ptr)
+				impl.deleter()(impl.ptr);
+		}
+	private:
+		__unique_ptr_storage<T, D> impl;
 	};
 
 
 	// swap
 	template<typename T, typename D>
 	inline void
-		swap(unique_ptr<T, D>& lhs, unique_ptr<T, D>& rhs)
+		swap(unique_ptr<T, D>& lhs, unique_ptr<T, D>& rhs) noexcept
 	{
 		using std::swap;
-		swap(lhs.ptr, rhs.ptr);
-		swap(lhs.deleter, rhs.deleter);
+		swap(lhs.impl.ptr, rhs.impl.ptr);
+		swap(lhs.impl.deleter(), rhs.impl.deleter());
 	}
 
-	// move assignment
+	// move assignment, the old pointee is freed after the new one is taken over,
+	// so that self-assignment is harmless
 	template<typename T, typename D>
 	inline unique_ptr<T, D>&
 		unique_ptr<T, D>::operator =(unique_ptr&& rhs) noexcept
 	{
-		// prevent self-assignment
-		if (this->ptr != rhs.ptr)
-		{
-			deleter(ptr);
-			ptr = nullptr;
-			::swap(*this, rhs);
-		}
+		reset(rhs.release());
+		impl.deleter() = std::forward<D>(rhs.get_deleter());
 		return *this;
 	}
 
@@ -125,197 +274,872 @@ namespace Tiny_STL {
 	// std::nullptr_t assignment
 	template<typename T, typename D>
 	inline unique_ptr<T, D>&
-		unique_ptr<T, D>::operator =(std::nullptr_t n) noexcept
+		unique_ptr<T, D>::operator =(std::nullptr_t) noexcept
 	{
-		if (n == nullptr)
-		{
-			deleter(ptr);
-			ptr = nullptr;
-		}
+		reset();
 		return *this;
 	}
 
+	// point to p, then free the old pointee
+	template<typename T, typename D>
+	inline void
+		unique_ptr<T, D>::reset(T* p) noexcept
+	{
+		T* old = impl.ptr;
+		impl.ptr = p;
+		if (old)
+			impl.deleter()(old);
+	}
+
 	// relinquish contrul by returnning ptr and making ptr point to nullptr.
 	template<typename T, typename D>
 	inline T*
-		unique_ptr<T, D>::release()
+		unique_ptr<T, D>::release() noexcept
 	{
-		T* ret = ptr;
-		ptr = nullptr;
+		T* ret = impl.ptr;
+		impl.ptr = nullptr;
 		return ret;
 	}
 
-}
 
+	//
+	//  Control block of shared_ptr
+	//
+	//  Holds the strong count, and knows how to dispose of the managed object and how to free itself.
+	//  Increments are relaxed: a new owner is always made from an existing one, which keeps the block alive.
+	//  Decrements are acq_rel, so every write made through any owner happens before the object is destroyed.
+	class __shared_count
+	{
+	public:
+		__shared_count() noexcept : uses(1) { }
+		__shared_count(const __shared_count&) = delete;
+		__shared_count& operator=(const __shared_count&) = delete;
 
-template<typename T>
-class shared_ptr;
+		void add_ref() noexcept { uses.fetch_add(1, std::memory_order_relaxed); }
+		void release() noexcept
+		{
+			if (uses.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+				dispose();
+				destroy();
+			}
+		}
+		long use_count() const noexcept { return uses.load(std::memory_order_relaxed); }
 
-template<typename T>
-auto swap(shared_ptr<T>& lhs, shared_ptr<T>& rhs)
-{
-	using std::swap;
-	swap(lhs.ptr, rhs.ptr);
-	swap(lhs.ref_count, rhs.ref_count);
-	swap(lhs.deleter, rhs.deleter);
-}
+	protected:
+		virtual ~__shared_count() { }
+		// destroy the managed object
+		virtual void dispose() noexcept = 0;
+		// free the block itself
+		virtual void destroy() noexcept = 0;
 
-template<typename T>
-class shared_ptr
-{
-public:
-	//
-	//  Default Ctor
-	//
-	shared_ptr()
-		: ptr{ nullptr }, ref_count{ new std::size_t(1) }, deleter{ Tiny_STL::default_delete<T>() }
-	{ }
-	//
-	//  Ctor that takes raw pointer
-	//
-	explicit shared_ptr(T* raw_ptr)
-		: ptr{ raw_ptr }, ref_count{ new std::size_t(1) }, deleter{ Tiny_STL::default_delete<T>() }
-	{ }
-	//
-	//  Copy Ctor
-	//
-	shared_ptr(const shared_ptr& other)
-		: ptr{ other.ptr }, ref_count{ other.ref_count }, deleter{ other.deleter }
+	private:
+		std::atomic<long> uses;
+	};
+
+	// block for a pointer adopted by shared_ptr, the deleter is erased into it
+	template<typename P, typename D>
+	class __shared_count_ptr : public __shared_count
+	{
+	public:
+		__shared_count_ptr(P p, D d) : ptr(p), deleter(std::move(d)) { }
+
+		void dispose() noexcept override { deleter(ptr); }
+		void destroy() noexcept override
+		{
+			this->~__shared_count_ptr();
+			allocator<__shared_count_ptr>::deallocate(this);
+		}
+
+	private:
+		P ptr;
+		D deleter;
+	};
+
+	// rebinds a single-parameter allocator template such as allocator<T> or std::allocator<T> to U
+	template<typename Alloc, typename U>
+	struct __rebind_alloc;
+
+	template<template<typename> class A, typename T, typename U>
+	struct __rebind_alloc<A<T>, U>
+	{
+		typedef A<U> type;
+	};
+
+	// block of make_shared and allocate_shared, the object lives inside it
+	// the allocator is rebound to the block and default constructed, so it must be stateless
+	template<typename T, typename Alloc>
+	class __shared_count_inplace : public __shared_count
+	{
+		typedef typename __rebind_alloc<Alloc, __shared_count_inplace>::type block_allocator;
+	public:
+		template<typename... Args>
+		explicit __shared_count_inplace(Args&&... args)
+		{
+			::new(static_cast<void *>(&storage)) T(std::forward<Args>(args)...);
+		}
+
+		T* get() noexcept { return reinterpret_cast<T*>(&storage); }
+		void dispose() noexcept override { get()->~T(); }
+		void destroy() noexcept override
+		{
+			block_allocator a;
+			this->~__shared_count_inplace();
+			a.deallocate(this, 1);
+		}
+
+	private:
+		typename std::aligned_storage<sizeof(T), alignof(T)>::type storage;
+	};
+
+
+	template<typename T>
+	class shared_ptr
+	{
+		template<typename> friend class shared_ptr;
+		template<typename> friend class atomic_shared_ptr;
+		template<typename U, typename Alloc, typename... Args>
+		friend shared_ptr<U> allocate_shared(const Alloc&, Args&&...);
+
+		template<typename U>
+		using enable_if_convertible = typename std::enable_if<std::is_convertible<U*, T*>::value>::type;
+
+	public:
+		typedef T element_type;
+
+		//
+		//  Default Ctor, owns nothing and allocates nothing
+		//
+		constexpr shared_ptr() noexcept
+			: ptr{ nullptr }, ctrl{ nullptr }
+		{ }
+		constexpr shared_ptr(std::nullptr_t) noexcept
+			: ptr{ nullptr }, ctrl{ nullptr }
+		{ }
+		//
+		//  Ctor that takes raw pointer, with an optional deleter
+		//  the pointer is deleted if the control block cannot be allocated
+		//
+		template<typename U, typename = enable_if_convertible<U>>
+		explicit shared_ptr(U* raw_ptr)
+			: ptr{ raw_ptr }, ctrl{ make_block(raw_ptr, default_delete<U>()) }
+		{ }
+		template<typename U, typename D, typename = enable_if_convertible<U>>
+		shared_ptr(U* raw_ptr, D d)
+			: ptr{ raw_ptr }, ctrl{ make_block(raw_ptr, std::move(d)) }
+		{ }
+		//
+		//  Ctor that takes over a unique_ptr together with its deleter
+		//
+		template<typename U, typename D, typename = enable_if_convertible<U>>
+		shared_ptr(unique_ptr<U, D>&& other)
+			: ptr{ other.get() }, ctrl{ nullptr }
+		{
+			if (ptr) {
+				ctrl = make_block(other.get(), std::move(other.get_deleter()));
+				other.release();
+			}
+		}
+		//
+		//  Aliasing Ctor, shares the ownership of other but points to p
+		//
+		template<typename U>
+		shared_ptr(const shared_ptr<U>& other, T* p) noexcept
+			: ptr{ p }, ctrl{ other.ctrl }
+		{
+			if (ctrl)
+				ctrl->add_ref();
+		}
+		//
+		//  Copy Ctor
+		//
+		shared_ptr(const shared_ptr& other) noexcept
+			: ptr{ other.ptr }, ctrl{ other.ctrl }
+		{
+			if (ctrl)
+				ctrl->add_ref();
+		}
+		template<typename U, typename = enable_if_convertible<U>>
+		shared_ptr(const shared_ptr<U>& other) noexcept
+			: ptr{ other.ptr }, ctrl{ other.ctrl }
+		{
+			if (ctrl)
+				ctrl->add_ref();
+		}
+		//
+		//  Move Ctor
+		//
+		shared_ptr(shared_ptr&& other) noexcept
+			: ptr{ other.ptr }, ctrl{ other.ctrl }
+		{
+			other.ptr = nullptr;
+			other.ctrl = nullptr;
+		}
+		template<typename U, typename = enable_if_convertible<U>>
+		shared_ptr(shared_ptr<U>&& other) noexcept
+			: ptr{ other.ptr }, ctrl{ other.ctrl }
+		{
+			other.ptr = nullptr;
+			other.ctrl = nullptr;
+		}
+		//
+		//  Copy assignment
+		//
+		shared_ptr& operator=(const shared_ptr& rhs) noexcept
+		{
+			shared_ptr(rhs).swap(*this);
+			return *this;
+		}
+		template<typename U, typename = enable_if_convertible<U>>
+		shared_ptr& operator=(const shared_ptr<U>& rhs) noexcept
+		{
+			shared_ptr(rhs).swap(*this);
+			return *this;
+		}
+		//
+		//  Move assignment, takes both pointers over and drops the old reference
+		//
+		shared_ptr& operator=(shared_ptr&& rhs) noexcept
+		{
+			__shared_count* old = ctrl;
+			ptr = rhs.ptr;
+			ctrl = rhs.ctrl;
+			rhs.ptr = nullptr;
+			rhs.ctrl = nullptr;
+			if (old)
+				old->release();
+			return *this;
+		}
+		template<typename U, typename = enable_if_convertible<U>>
+		shared_ptr& operator=(shared_ptr<U>&& rhs) noexcept
+		{
+			shared_ptr(std::move(rhs)).swap(*this);
+			return *this;
+		}
+		//
+		//  nullptr assignment
+		//
+		shared_ptr& operator=(std::nullptr_t) noexcept
+		{
+			reset();
+			return *this;
+		}
+		//
+		//  Dtor
+		//
+		~shared_ptr()
+		{
+			static_assert(sizeof(shared_ptr) == 2 * sizeof(void *), "shared_ptr must stay two pointers wide");
+			if (ctrl)
+				ctrl->release();
+		}
+
+		//
+		//  Conversion operator
+		//
+		explicit operator bool() const noexcept
+		{
+			return ptr ? true : false;
+		}
+		//
+		//  Dereference
+		//
+		T& operator* () const noexcept
+		{
+			return *ptr;
+		}
+		//
+		//  Arrow
+		//
+		T* operator->() const noexcept
+		{
+			return ptr;
+		}
+		//
+		//  Get underlying pointer
+		//
+		T* get() const noexcept
+		{
+			return ptr;
+		}
+		//
+		//  Use count, 0 when empty
+		//
+		long use_count() const noexcept
+		{
+			return ctrl ? ctrl->use_count() : 0;
+		}
+		//
+		//  Check if the unique user
+		//
+		bool unique() const noexcept
+		{
+			return use_count() == 1;
+		}
+		//
+		//  Swap
+		//
+		void swap(shared_ptr& rhs) noexcept
+		{
+			std::swap(ptr, rhs.ptr);
+			std::swap(ctrl, rhs.ctrl);
+		}
+		//
+		// Release the ownership
+		//
+		void reset() noexcept
+		{
+			if (ctrl)
+				ctrl->release();
+			ptr = nullptr;
+			ctrl = nullptr;
+		}
+		//
+		// Reset with the new raw pointer, and a deleter
+		//
+		template<typename U, typename = enable_if_convertible<U>>
+		void reset(U* pointer)
+		{
+			shared_ptr(pointer).swap(*this);
+		}
+		template<typename U, typename D, typename = enable_if_convertible<U>>
+		void reset(U* pointer, D d)
+		{
+			shared_ptr(pointer, std::move(d)).swap(*this);
+		}
+
+	private:
+		T* ptr;
+		__shared_count* ctrl;
+
+		template<typename U, typename D>
+		static __shared_count* make_block(U* p, D d)
+		{
+			typedef __shared_count_ptr<U*, D> block;
+			block* b;
+			try {
+				b = allocator<block>::allocate();
+			}
+			catch (...) {
+				d(p);
+				throw;
+			}
+			return ::new(static_cast<void *>(b)) block(p, std::move(d));
+		}
+	};
+
+	template<typename T, typename U>
+	inline bool operator==(const shared_ptr<T>& lhs, const shared_ptr<U>& rhs) noexcept
 	{
-		++*ref_count;
+		return lhs.get() == rhs.get();
 	}
-	//
-	//  Move Ctor
-	//
-	shared_ptr(shared_ptr && other) noexcept
-		: ptr{ other.ptr }, ref_count{ other.ref_count }, deleter{ std::move(other.deleter) }
+	template<typename T, typename U>
+	inline bool operator!=(const shared_ptr<T>& lhs, const shared_ptr<U>& rhs) noexcept
 	{
-		other.ptr = other.ref_count = nullptr;
+		return lhs.get() != rhs.get();
 	}
-	//
-	//  Copy assignment
-	//
-	shared_ptr& operator=(shared_ptr const& rhs)
+	template<typename T>
+	inline bool operator==(const shared_ptr<T>& lhs, std::nullptr_t) noexcept
 	{
-		//increment first to ensure safty for self-assignment
-		++*rhs.ref_count;
-		decrement_and_destroy();
-		ptr = rhs.ptr, ref_count = rhs.ref_count, deleter = rhs.deleter;
-		return *this;
+		return !lhs;
 	}
-	//
-	//  Move assignment
-	//
-	shared_ptr& operator=(shared_ptr && rhs) noexcept
+	template<typename T>
+	inline bool operator!=(const shared_ptr<T>& lhs, std::nullptr_t) noexcept
 	{
-		swap(*this, rhs);
-		rhs.decrement_and_destroy();
-		return *this;
+		return static_cast<bool>(lhs);
 	}
-	//
-	//  Conversion operator
-	//
-	operator bool() const
+	template<typename T>
+	inline bool operator==(std::nullptr_t, const shared_ptr<T>& rhs) noexcept
 	{
-		return ptr ? true : false;
+		return !rhs;
 	}
-	//
-	//  Dereference
-	//
-	T& operator* () const
+	template<typename T>
+	inline bool operator!=(std::nullptr_t, const shared_ptr<T>& rhs) noexcept
 	{
-		return *ptr;
+		return static_cast<bool>(rhs);
 	}
-	//
-	//  Arrow
-	//
-	T* operator->() const
+
+	template<typename T>
+	inline void swap(shared_ptr<T>& lhs, shared_ptr<T>& rhs) noexcept
 	{
-		return &*ptr;
+		lhs.swap(rhs);
 	}
+
 	//
-	//  Use count
+	//  The object and its control block in a single allocation from Alloc
 	//
-	auto use_count() const
+	template<typename T, typename Alloc, typename... Args>
+	inline shared_ptr<T> allocate_shared(const Alloc&, Args&&... args)
 	{
-		return *ref_count;
+		typedef __shared_count_inplace<T, Alloc> block;
+		typename __rebind_alloc<Alloc, block>::type a;
+		block* b = a.allocate(1);
+		try {
+			::new(static_cast<void *>(b)) block(std::forward<Args>(args)...);
+		}
+		catch (...) {
+			a.deallocate(b, 1);
+			throw;
+		}
+		shared_ptr<T> result;
+		result.ptr = b->get();
+		result.ctrl = b;
+		return result;
 	}
-	//
-	//  Get underlying pointer
-	//
-	auto get() const
+
+	template<typename T, typename... Args>
+	inline shared_ptr<T> make_shared(Args&&... args)
 	{
-		return ptr;
+		return Tiny_STL::allocate_shared<T>(allocator<T>(), std::forward<Args>(args)...);
 	}
+
+
 	//
-	//  Check if the unique user
+	//  shared_ptr that can be loaded and replaced from many threads at once, without a lock
 	//
-	auto unique() const
+	//  Each stored value lives in a node, published through one word that also counts the loads in flight
+	//  (split reference count): load() borrows the node with a single fetch_add on the word, copies
+	//  the shared_ptr out of it and gives the borrowed count back.
+	//  A writer that swaps a node out moves the count left in the word over to the node's own count,
+	//  so the node is freed only once every load that borrowed it is done.
+	//  Storing a non-empty value allocates a node, the type is meant for values read far more often than written.
+	//  The node pointer takes the low 48 bits of the word and the count the high 16 on 64-bit targets,
+	//  the low 33 and the high 31 on 32-bit ones.
+	//  Limits: at most max_loads_in_flight loads, compare_exchanges included, may run on the same object
+	//  at once, one more wraps the count and corrupts the object (debug builds assert on it).
+	//  A node the allocator places above the 48-bit range cannot be published: storing it throws
+	//  std::bad_alloc, in release builds too, so targets with wider user addresses are not supported.
+	template<typename T>
+	class atomic_shared_ptr
 	{
-		return 1 == *refCount;
-	}
+		struct node
+		{
+			explicit node(shared_ptr<T>&& v) noexcept : refs(1), value(std::move(v)) { }
+			// one for the word publishing it, plus the borrowed counts moved over when it is swapped out
+			std::atomic<long> refs;
+			shared_ptr<T> value;
+		};
+
+		typedef uint64_t word_type;
+		static_assert(sizeof(uintptr_t) <= sizeof(word_type), "atomic_shared_ptr: pointers wider than 64 bits are not supported");
+		// the count stays below 2^31 so that it fits a long
+		static constexpr unsigned Count_shift = sizeof(uintptr_t) > 4 ? 48 : 33;
+		static constexpr word_type Count_one = word_type(1) << Count_shift;
+		static constexpr word_type Node_mask = Count_one - 1;
+
+	public:
+		typedef shared_ptr<T> value_type;
+
+		static constexpr long max_loads_in_flight = static_cast<long>((word_type(1) << (64 - Count_shift)) - 1);
+
+		constexpr atomic_shared_ptr() noexcept
+			: word{ 0 }
+		{ }
+		atomic_shared_ptr(shared_ptr<T> desired)
+			: word{ make_word(std::move(desired)) }
+		{ }
+		atomic_shared_ptr(const atomic_shared_ptr&) = delete;
+		atomic_shared_ptr& operator=(const atomic_shared_ptr&) = delete;
+		~atomic_shared_ptr()
+		{
+			unref(node_of(word.load(std::memory_order_relaxed)), 0);
+		}
+
+		bool is_lock_free() const noexcept
+		{
+			return word.is_lock_free();
+		}
+
+		//
+		//  Copy of the current value
+		//
+		shared_ptr<T> load() const noexcept
+		{
+			node* n = node_of(borrow());
+			shared_ptr<T> result;
+			if (n)
+				result = n->value;
+			give_back(n);
+			return result;
+		}
+		operator shared_ptr<T>() const noexcept
+		{
+			return load();
+		}
+		//
+		//  Replace the value, the old one is released once the last load of it is done
+		//
+		void store(shared_ptr<T> desired)
+		{
+			exchange(std::move(desired));
+		}
+		void operator=(shared_ptr<T> desired)
+		{
+			store(std::move(desired));
+		}
+		shared_ptr<T> exchange(shared_ptr<T> desired)
+		{
+			word_type w = word.exchange(make_word(std::move(desired)), std::memory_order_acq_rel);
+			node* n = node_of(w);
+			if (!n)
+				return shared_ptr<T>();
+			shared_ptr<T> result(n->value);
+			unref(n, count_of(w));
+			return result;
+		}
+		//
+		//  Replace the value with desired if it is expected, sharing both its pointer and its ownership
+		//  otherwise copy the value into expected
+		//
+		bool compare_exchange_strong(shared_ptr<T>& expected, shared_ptr<T> desired)
+		{
+			word_type next = make_word(std::move(desired));
+			for (;;) {
+				word_type w = borrow() + Count_one;
+				node* n = node_of(w);
+				if (!holds(n, expected)) {
+					expected = n ? n->value : shared_ptr<T>();
+					give_back(n);
+					unref(node_of(next), 0);
+					return false;
+				}
+				while (node_of(w) == n) {
+					if (word.compare_exchange_weak(w, next, std::memory_order_acq_rel, std::memory_order_relaxed)) {
+						// the count we borrowed left with the word
+						unref(n, count_of(w) - 1);
+						return true;
+					}
+				}
+				// swapped out meanwhile, our borrowed count was moved over to n
+				unref(n, 0);
+			}
+		}
+		bool compare_exchange_weak(shared_ptr<T>& expected, shared_ptr<T> desired)
+		{
+			return compare_exchange_strong(expected, std::move(desired));
+		}
+
+	private:
+		mutable std::atomic<word_type> word;
+
+		static node* node_of(word_type w) noexcept
+		{
+			return reinterpret_cast<node*>(static_cast<uintptr_t>(w & Node_mask));
+		}
+		static long count_of(word_type w) noexcept
+		{
+			return static_cast<long>(w >> Count_shift);
+		}
+		static bool holds(node* n, const shared_ptr<T>& p) noexcept
+		{
+			return n ? n->value.ptr == p.ptr && n->value.ctrl == p.ctrl : !p.ptr && !p.ctrl;
+		}
+		// an empty value is published as the null word, without a node
+		static word_type make_word(shared_ptr<T>&& v)
+		{
+			if (!v.ptr && !v.ctrl)
+				return 0;
+			node* n = allocator<node>::allocate();
+			::new(static_cast<void *>(n)) node(std::move(v));
+			word_type w = static_cast<word_type>(reinterpret_cast<uintptr_t>(n));
+			if (w & ~Node_mask) {
+				allocator<node>::destroy(n);
+				allocator<node>::deallocate(n);
+				throw std::bad_alloc();
+			}
+			return w;
+		}
+		// takes one count on the word, returns the word before
+		word_type borrow() const noexcept
+		{
+			word_type w = word.fetch_add(Count_one, std::memory_order_acquire);
+			assert(count_of(w) < max_loads_in_flight && "atomic_shared_ptr: too many loads in flight");
+			return w;
+		}
+		// adds the borrowed counts to n, then drops one reference
+		static void unref(node* n, long borrowed) noexcept
+		{
+			if (n && n->refs.fetch_add(borrowed - 1, std::memory_order_acq_rel) == 1 - borrowed) {
+				allocator<node>::destroy(n);
+				allocator<node>::deallocate(n);
+			}
+		}
+		// returns the count borrowed from the word, or the reference it turned into if n was swapped out
+		void give_back(node* n) const noexcept
+		{
+			word_type w = word.load(std::memory_order_relaxed);
+			while (node_of(w) == n) {
+				if (word.compare_exchange_weak(w, w - Count_one, std::memory_order_release, std::memory_order_relaxed))
+					return;
+			}
+			unref(n, 0);
+		}
+	};
+
+
+
 	//
-	//  Swap
+	//  Counter policies of ref_counted
 	//
-	void swap(shared_ptr& rhs)
+	//  thread_safe_counter follows the control block of shared_ptr: relaxed increments, acq_rel decrements.
+	//  thread_unsafe_counter is a plain long, for objects that never leave one thread.
+	struct thread_safe_counter
 	{
-		::swap(*this, rhs);
-	}
+		typedef std::atomic<long> type;
+		static void increment(type& c) noexcept { c.fetch_add(1, std::memory_order_relaxed); }
+		static long decrement(type& c) noexcept { return c.fetch_sub(1, std::memory_order_acq_rel) - 1; }
+		static long load(const type& c) noexcept { return c.load(std::memory_order_relaxed); }
+	};
+
+	struct thread_unsafe_counter
+	{
+		typedef long type;
+		static void increment(type& c) noexcept { ++c; }
+		static long decrement(type& c) noexcept { return --c; }
+		static long load(const type& c) noexcept { return c; }
+	};
+
 	//
-	// Free the object pointed to, if unique
+	//  Base that embeds the reference count into T (CRTP), for use with intrusive_ptr
 	//
-	auto reset()
+	//  The count starts at 0, the first intrusive_ptr takes it to 1.
+	//  When it drops back to 0 the object is destroyed by Deleter,
+	//  allocator_delete<T> pairs with allocate_intrusive, default_delete<T> with new and make_intrusive.
+	//  Copying an object does not copy its count.
+	template<typename T, typename Policy = thread_safe_counter, typename Deleter = default_delete<T>>
+	class ref_counted
 	{
-		decrement_and_destroy();
-	}
+	public:
+		typedef Deleter ref_counted_deleter;
+
+		long use_count() const noexcept { return Policy::load(refs); }
+
+		friend void intrusive_ptr_add_ref(const ref_counted* p) noexcept
+		{
+			Policy::increment(p->refs);
+		}
+		friend void intrusive_ptr_release(const ref_counted* p) noexcept
+		{
+			if (Policy::decrement(p->refs) == 0)
+				Deleter()(static_cast<T*>(const_cast<ref_counted*>(p)));
+		}
+
+	protected:
+		ref_counted() noexcept : refs(0) { }
+		ref_counted(const ref_counted&) noexcept : refs(0) { }
+		ref_counted& operator=(const ref_counted&) noexcept { return *this; }
+		~ref_counted() { }
+
+	private:
+		mutable typename Policy::type refs;
+	};
+
+	// how the last release frees a T: the Deleter of its ref_counted base, default_delete for other types
+	template<typename T, typename = void>
+	struct __intrusive_deleter
+	{
+		typedef default_delete<T> type;
+	};
+	template<typename T>
+	struct __intrusive_deleter<T, typename std::conditional<true, void, typename T::ref_counted_deleter>::type>
+	{
+		typedef typename T::ref_counted_deleter type;
+	};
+
+	template<typename D>
+	struct __is_default_delete : std::false_type { };
+	template<typename T>
+	struct __is_default_delete<default_delete<T>> : std::true_type { };
+
 	//
-	// Reset with the new raw pointer
+	//  Pointer to an object that counts its own references
 	//
-	auto reset(T* pointer)
+	//  One pointer wide and allocates nothing: the count is reached through the unqualified calls
+	//  intrusive_ptr_add_ref(T*) and intrusive_ptr_release(T*), found by ADL,
+	//  which ref_counted provides and any other type may define.
+	template<typename T>
+	class intrusive_ptr
 	{
-		if (ptr != pointer)
+		template<typename> friend class intrusive_ptr;
+
+		template<typename U>
+		using enable_if_convertible = typename std::enable_if<std::is_convertible<U*, T*>::value>::type;
+
+	public:
+		typedef T element_type;
+
+		//
+		//  Default Ctor
+		//
+		constexpr intrusive_ptr() noexcept
+			: ptr{ nullptr }
+		{ }
+		constexpr intrusive_ptr(std::nullptr_t) noexcept
+			: ptr{ nullptr }
+		{ }
+		//
+		//  Ctor that takes raw pointer, add_ref is false to adopt a reference already counted
+		//
+		intrusive_ptr(T* raw_ptr, bool add_ref = true) noexcept
+			: ptr{ raw_ptr }
+		{
+			if (ptr && add_ref)
+				intrusive_ptr_add_ref(ptr);
+		}
+		//
+		//  Ctor that takes over an object owned by a unique_ptr
+		//  the object's last release must free it the way D would
+		//
+		template<typename U, typename D, typename = enable_if_convertible<U>>
+		intrusive_ptr(unique_ptr<U, D>&& other) noexcept
+			: intrusive_ptr(other.release())
+		{
+			typedef typename __intrusive_deleter<U>::type release_deleter;
+			static_assert(std::is_same<D, release_deleter>::value ||
+				(__is_default_delete<D>::value && __is_default_delete<release_deleter>::value),
+				"intrusive_ptr: the unique_ptr's deleter does not match how the object releases itself");
+		}
+		//
+		//  Copy Ctor
+		//
+		intrusive_ptr(const intrusive_ptr& other) noexcept
+			: intrusive_ptr(other.ptr)
+		{ }
+		template<typename U, typename = enable_if_convertible<U>>
+		intrusive_ptr(const intrusive_ptr<U>& other) noexcept
+			: intrusive_ptr(other.ptr)
+		{ }
+		//
+		//  Move Ctor
+		//
+		intrusive_ptr(intrusive_ptr&& other) noexcept
+			: ptr{ other.ptr }
 		{
-			decrement_n_destroy();
-			ptr = pointer;
-			ref_count = new std::size_t(1);
+			other.ptr = nullptr;
 		}
+		template<typename U, typename = enable_if_convertible<U>>
+		intrusive_ptr(intrusive_ptr<U>&& other) noexcept
+			: ptr{ other.ptr }
+		{
+			other.ptr = nullptr;
+		}
+		//
+		//  Assignment
+		//
+		intrusive_ptr& operator=(const intrusive_ptr& rhs) noexcept
+		{
+			intrusive_ptr(rhs).swap(*this);
+			return *this;
+		}
+		intrusive_ptr& operator=(intrusive_ptr&& rhs) noexcept
+		{
+			intrusive_ptr(std::move(rhs)).swap(*this);
+			return *this;
+		}
+		intrusive_ptr& operator=(std::nullptr_t) noexcept
+		{
+			reset();
+			return *this;
+		}
+		//
+		//  Dtor
+		//
+		~intrusive_ptr()
+		{
+			static_assert(sizeof(intrusive_ptr) == sizeof(void *), "intrusive_ptr must stay one pointer wide");
+			if (ptr)
+				intrusive_ptr_release(ptr);
+		}
+
+		explicit operator bool() const noexcept { return ptr ? true : false; }
+		T& operator* () const noexcept { return *ptr; }
+		T* operator->() const noexcept { return ptr; }
+		T* get() const noexcept { return ptr; }
+		//
+		//  Give up the reference without releasing it
+		//
+		T* detach() noexcept
+		{
+			T* ret = ptr;
+			ptr = nullptr;
+			return ret;
+		}
+		void swap(intrusive_ptr& rhs) noexcept { std::swap(ptr, rhs.ptr); }
+		void reset() noexcept { intrusive_ptr().swap(*this); }
+		void reset(T* raw_ptr, bool add_ref = true) noexcept { intrusive_ptr(raw_ptr, add_ref).swap(*this); }
+
+	private:
+		T* ptr;
+	};
+
+	template<typename T, typename U>
+	inline bool operator==(const intrusive_ptr<T>& lhs, const intrusive_ptr<U>& rhs) noexcept
+	{
+		return lhs.get() == rhs.get();
 	}
-	//
-	//  Reset with raw pointer and deleter
-	//
-	auto reset(T *pointer, const std::function<void(T*)>& d)
+	template<typename T, typename U>
+	inline bool operator!=(const intrusive_ptr<T>& lhs, const intrusive_ptr<U>& rhs) noexcept
+	{
+		return lhs.get() != rhs.get();
+	}
+	template<typename T>
+	inline bool operator==(const intrusive_ptr<T>& lhs, std::nullptr_t) noexcept
 	{
-		reset(pointer);
-		deleter = d;
+		return !lhs;
 	}
+	template<typename T>
+	inline bool operator!=(const intrusive_ptr<T>& lhs, std::nullptr_t) noexcept
+	{
+		return static_cast<bool>(lhs);
+	}
+	template<typename T>
+	inline bool operator==(std::nullptr_t, const intrusive_ptr<T>& rhs) noexcept
+	{
+		return !rhs;
+	}
+	template<typename T>
+	inline bool operator!=(std::nullptr_t, const intrusive_ptr<T>& rhs) noexcept
+	{
+		return static_cast<bool>(rhs);
+	}
+
+	template<typename T>
+	inline void swap(intrusive_ptr<T>& lhs, intrusive_ptr<T>& rhs) noexcept
+	{
+		lhs.swap(rhs);
+	}
+
 	//
-	//  Dtor
+	//  Objects destroyed by default_delete
 	//
-	~shared_ptr()
+	template<typename T, typename... Args>
+	inline intrusive_ptr<T> make_intrusive(Args&&... args)
 	{
-		decrement_and_destroy();
+		static_assert(__is_default_delete<typename __intrusive_deleter<T>::type>::value,
+			"make_intrusive: T does not release itself with default_delete, use allocate_intrusive");
+		return intrusive_ptr<T>(new T(std::forward<Args>(args)...));
 	}
-private:
-	T* ptr;
-	size_t* ref_count;
-	std::function<void(T*)> deleter;
 
-	auto decrement_and_destroy()
+	//
+	//  Objects destroyed by allocator_delete, the memory comes from alloc
+	//  T must derive from ref_counted<T, Policy, allocator_delete<T>> itself:
+	//  allocator_delete<Base> would give back sizeof(Base) bytes of a T
+	//
+	template<typename T, typename... Args>
+	inline intrusive_ptr<T> allocate_intrusive(Args&&... args)
 	{
-		if (ptr && 0 == --*ref_count) {
-			delete ref_count,
-				deleter(ptr);
+		static_assert(std::is_same<typename __intrusive_deleter<T>::type, allocator_delete<T>>::value,
+			"allocate_intrusive: T does not release itself with allocator_delete<T>");
+		T* p = allocator<T>::allocate();
+		try {
+			allocator<T>::construct(p, std::forward<Args>(args)...);
+		}
+		catch (...) {
+			allocator<T>::deallocate(p);
+			throw;
 		}
-		else if (!ptr)
-			delete ref_count;
-		ref_count = nullptr;
-		ptr = nullptr;
+		return intrusive_ptr<T>(p);
 	}
-};
 
-template<typename T, typename...Args>
-shared_ptr<T> make_shared(Args&&... args) {
-	return shared_ptr<T>(new T(std::forward<Args>(args)...));
 }
 
 #endif // !MEMORY_H
@@ -0,0 +1,137 @@
+#pragma once
+#ifndef TINYSTL_SMALL_VECTOR_H
+#define TINYSTL_SMALL_VECTOR_H
+#include"vector.h"
+
+//vector with room for N elements inside the object itself
+//the heap (through Alloc) is only used once it grows past N elements
+//all operations but construction, moves, swap and shrink_to_fit are vector's, see __vector_base
+
+namespace Tiny_STL {
+
+	template<typename T, size_t N, typename Alloc = allocator<T>>
+	class small_vector :public __vector_base<T, Alloc, small_vector<T, N, Alloc>> {
+		static_assert(N > 0, "small_vector needs at least one inline element");
+		typedef __vector_base<T, Alloc, small_vector<T, N, Alloc>> base;
+		friend base;
+	public:
+		typedef typename base::size_type		size_type;
+		typedef typename base::iterator			iterator;
+		typedef typename base::const_iterator	const_iterator;
+
+	private:
+		typedef typename base::data_allocator data_allocator;
+		typedef typename base::relocator relocator;
+
+		typename std::aligned_storage<sizeof(T) * N, alignof(T)>::type buffer;
+
+	public:
+		//constructors
+		small_vector() noexcept :base(inline_storage(), inline_storage(), inline_storage() + N) { }
+		explicit small_vector(size_type n) :small_vector() { this->resize(n); }
+		small_vector(size_type n, const T& value) :small_vector() { this->assign(n, value); }
+		template<typename InputIterator,
+			typename = typename std::enable_if<!std::is_integral<InputIterator>::value>::type>
+		small_vector(InputIterator first, InputIterator last) :small_vector() { this->assign(first, last); }
+		small_vector(std::initializer_list<T> il) :small_vector() { this->assign(il.begin(), il.end()); }
+		small_vector(const small_vector& rhs) :small_vector() { this->assign(rhs.begin(), rhs.end()); }
+		small_vector(small_vector&& rhs) noexcept(std::is_nothrow_move_constructible<T>::value)
+			:small_vector() {
+			steal(rhs);
+		}
+		~small_vector() { this->release_storage(); }
+
+		small_vector& operator=(const small_vector& rhs) {
+			if (this != &rhs)
+				this->assign(rhs.begin(), rhs.end());
+			return *this;
+		}
+		small_vector& operator=(small_vector&& rhs) noexcept(std::is_nothrow_move_constructible<T>::value) {
+			if (this != &rhs) {
+				this->release_storage();
+				this->start = this->finish = inline_storage();
+				this->end_of_storage = this->start + N;
+				steal(rhs);
+			}
+			return *this;
+		}
+		small_vector& operator=(std::initializer_list<T> il) {
+			this->assign(il.begin(), il.end());
+			return *this;
+		}
+
+	public:
+		static constexpr size_type inline_capacity() noexcept { return N; }
+		//whether the elements live in the inline buffer
+		bool is_inline() const noexcept { return this->start == inline_storage(); }
+		//moves the elements back into the inline buffer when they fit
+		void shrink_to_fit();
+		void swap(small_vector& rhs);
+
+	private:
+		iterator inline_storage() noexcept { return reinterpret_cast<iterator>(&buffer); }
+		const_iterator inline_storage() const noexcept { return reinterpret_cast<const_iterator>(&buffer); }
+		bool heap_allocated(const T* p) const noexcept { return p != inline_storage(); }
+		//take over the elements of rhs, which is left empty
+		void steal(small_vector& rhs);
+	};
+
+
+	//heap storage is handed over as is, inline elements have to be moved one by one
+	template<typename T, size_t N, typename Alloc>
+	void small_vector<T, N, Alloc>::steal(small_vector& rhs) {
+		if (!rhs.is_inline()) {
+			this->start = rhs.start;
+			this->finish = rhs.finish;
+			this->end_of_storage = rhs.end_of_storage;
+			rhs.start = rhs.finish = rhs.inline_storage();
+			rhs.end_of_storage = rhs.start + N;
+			return;
+		}
+		this->finish = Tiny_STL::uninitialized_move(rhs.start, rhs.finish, this->start);
+		rhs.clear();
+	}
+
+	template<typename T, size_t N, typename Alloc>
+	void small_vector<T, N, Alloc>::shrink_to_fit() {
+		if (is_inline() || this->finish == this->end_of_storage)
+			return;
+		if (this->size() > N) {
+			this->reallocate_storage(this->size(), std::false_type());
+			return;
+		}
+		const size_type n = this->size();
+		iterator heap = this->start;
+		size_type heap_cap = this->capacity();
+		relocator::transfer(this->start, this->finish, inline_storage());
+		relocator::release(this->start, this->finish);
+		data_allocator::deallocate(heap, heap_cap);
+		this->start = inline_storage();
+		this->finish = this->start + n;
+		this->end_of_storage = this->start + N;
+	}
+
+	//only two heap buffers can be swapped by pointer
+	template<typename T, size_t N, typename Alloc>
+	void small_vector<T, N, Alloc>::swap(small_vector& rhs) {
+		if (this == &rhs)
+			return;
+		if (!is_inline() && !rhs.is_inline()) {
+			std::swap(this->start, rhs.start);
+			std::swap(this->finish, rhs.finish);
+			std::swap(this->end_of_storage, rhs.end_of_storage);
+			return;
+		}
+		small_vector tmp(std::move(*this));
+		*this = std::move(rhs);
+		rhs = std::move(tmp);
+	}
+
+	template<typename T, size_t N, typename Alloc>
+	inline void swap(small_vector<T, N, Alloc>& lhs, small_vector<T, N, Alloc>& rhs) {
+		lhs.swap(rhs);
+	}
+
+}
+
+#endif // !TINYSTL_SMALL_VECTOR_H
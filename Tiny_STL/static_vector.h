@@ -0,0 +1,285 @@
+#pragma once
+#ifndef TINYSTL_STATIC_VECTOR_H
+#define TINYSTL_STATIC_VECTOR_H
+#include"uninitialized.h"
+#include"reverse_iterator.h"
+#include<cassert>
+#include<cstddef>
+#include<initializer_list>
+#include<new>
+#include<stdexcept>
+#include<type_traits>
+#include<utility>
+
+//vector with a capacity fixed at compile time, the elements live inside the object and nothing is ever allocated
+//for trivial types every operation is constexpr
+
+namespace Tiny_STL {
+
+	//trivial types: a plain array, so that the container stays a literal type
+	//before C++20 a constexpr constructor must initialize every member, so construction zeroes the whole array,
+	//a known cost for large N; from C++20 on this only happens during constant evaluation
+	//copies are the implicit ones and take all N elements, which keeps static_vector<T, N> trivially copyable
+	template<typename T, size_t N, bool = std::is_trivial<T>::value>
+	struct __static_vector_storage {
+		T elems[N];
+		size_t count;
+
+#if defined(__cpp_lib_is_constant_evaluated) && __cpp_constexpr >= 201907L
+		constexpr __static_vector_storage() :count(0) {
+			if (std::is_constant_evaluated())
+				for (size_t i = 0; i != N; ++i)
+					elems[i] = T();
+		}
+#else
+		constexpr __static_vector_storage() :elems(), count(0) { }
+#endif
+
+		constexpr T* ptr() { return elems; }
+		constexpr const T* ptr() const { return elems; }
+		template<typename... Args>
+		constexpr void construct(size_t i, Args&&... args) { elems[i] = T(std::forward<Args>(args)...); }
+		constexpr void destroy(size_t, size_t) { }
+	};
+
+	//other types: raw storage, objects are built with placement new
+	template<typename T, size_t N>
+	struct __static_vector_storage<T, N, false> {
+		typename std::aligned_storage<sizeof(T), alignof(T)>::type elems[N];
+		size_t count;
+
+		__static_vector_storage() :count(0) { }
+		__static_vector_storage(const __static_vector_storage& rhs) :count(0) {
+			Tiny_STL::uninitialized_copy(rhs.ptr(), rhs.ptr() + rhs.count, ptr());
+			count = rhs.count;
+		}
+		__static_vector_storage(__static_vector_storage&& rhs) noexcept(std::is_nothrow_move_constructible<T>::value)
+			:count(0) {
+			Tiny_STL::uninitialized_move(rhs.ptr(), rhs.ptr() + rhs.count, ptr());
+			count = rhs.count;
+		}
+		__static_vector_storage& operator=(const __static_vector_storage& rhs) {
+			if (this != &rhs)
+				assign_from(rhs.ptr(), rhs.count);
+			return *this;
+		}
+		__static_vector_storage& operator=(__static_vector_storage&& rhs) noexcept(std::is_nothrow_move_assignable<T>::value &&
+			std::is_nothrow_move_constructible<T>::value) {
+			if (this != &rhs)
+				assign_from(std::make_move_iterator(rhs.ptr()), rhs.count);
+			return *this;
+		}
+		~__static_vector_storage() { destroy(0, count); }
+
+		T* ptr() { return reinterpret_cast<T*>(elems); }
+		const T* ptr() const { return reinterpret_cast<const T*>(elems); }
+		template<typename... Args>
+		void construct(size_t i, Args&&... args) { new(static_cast<void *>(ptr() + i)) T(std::forward<Args>(args)...); }
+		void destroy(size_t first, size_t last) { Tiny_STL::destroy(ptr() + first, ptr() + last); }
+
+		//assign over the live elements, construct the rest
+		template<typename InputIterator>
+		void assign_from(InputIterator src, size_t n) {
+			size_t i = 0;
+			for (; i < n && i < count; ++i, ++src)
+				ptr()[i] = *src;
+			if (n < count) {
+				destroy(n, count);
+				count = n;
+			}
+			for (; i < n; ++i, ++src) {
+				construct(i, *src);
+				++count;
+			}
+		}
+	};
+
+
+	template<typename T, size_t N>
+	class static_vector :private __static_vector_storage<T, N> {
+		typedef __static_vector_storage<T, N> storage;
+	public:
+		typedef T										value_type;
+		typedef T*										pointer;
+		typedef const T*								const_pointer;
+		typedef T&										reference;
+		typedef const T&								const_reference;
+		typedef size_t									size_type;
+		typedef ptrdiff_t								difference_type;
+		typedef T*										iterator;
+		typedef const T*								const_iterator;
+		typedef Tiny_STL::reverse_iterator<iterator>		reverse_iterator;
+		typedef Tiny_STL::reverse_iterator<const_iterator>	const_reverse_iterator;
+
+	public:
+		//constructors, copies and the destructor come from the storage
+		constexpr static_vector() { }
+		constexpr static_vector(size_type n, const T& value) {
+			check(n);
+			for (size_type i = 0; i < n; ++i)
+				unchecked_push_back(value);
+		}
+		template<typename InputIterator,
+			typename = typename std::enable_if<!std::is_integral<InputIterator>::value>::type>
+		constexpr static_vector(InputIterator first, InputIterator last) {
+			for (; first != last; ++first)
+				emplace_back(*first);
+		}
+		constexpr static_vector(std::initializer_list<T> il) :static_vector(il.begin(), il.end()) { }
+
+	public:
+		//element access
+		constexpr reference at(size_type n) {
+			if (n >= size())
+				throw std::out_of_range("static_vector::at");
+			return data()[n];
+		}
+		constexpr const_reference at(size_type n) const {
+			if (n >= size())
+				throw std::out_of_range("static_vector::at");
+			return data()[n];
+		}
+		constexpr reference operator[](size_type n) { return data()[n]; }
+		constexpr const_reference operator[](size_type n) const { return data()[n]; }
+		constexpr reference front() { return data()[0]; }
+		constexpr const_reference front() const { return data()[0]; }
+		constexpr reference back() { return data()[size() - 1]; }
+		constexpr const_reference back() const { return data()[size() - 1]; }
+		constexpr pointer data() noexcept { return storage::ptr(); }
+		constexpr const_pointer data() const noexcept { return storage::ptr(); }
+
+		//iterators
+		constexpr iterator begin() noexcept { return data(); }
+		constexpr const_iterator begin() const noexcept { return data(); }
+		constexpr const_iterator cbegin() const noexcept { return data(); }
+		constexpr iterator end() noexcept { return data() + size(); }
+		constexpr const_iterator end() const noexcept { return data() + size(); }
+		constexpr const_iterator cend() const noexcept { return data() + size(); }
+		reverse_iterator rbegin() noexcept { return reverse_iterator(end()); }
+		const_reverse_iterator rbegin() const noexcept { return const_reverse_iterator(end()); }
+		const_reverse_iterator crbegin() const noexcept { return const_reverse_iterator(end()); }
+		reverse_iterator rend() noexcept { return reverse_iterator(begin()); }
+		const_reverse_iterator rend() const noexcept { return const_reverse_iterator(begin()); }
+		const_reverse_iterator crend() const noexcept { return const_reverse_iterator(begin()); }
+
+		//capacity
+		constexpr bool empty() const noexcept { return storage::count == 0; }
+		constexpr bool full() const noexcept { return storage::count == N; }
+		constexpr size_type size() const noexcept { return storage::count; }
+		static constexpr size_type max_size() noexcept { return N; }
+		static constexpr size_type capacity() noexcept { return N; }
+
+		//modifiers
+		//the checked versions throw std::length_error when the vector is full
+		constexpr void push_back(const T& value) { emplace_back(value); }
+		constexpr void push_back(T&& value) { emplace_back(std::move(value)); }
+		template<typename... Args>
+		constexpr reference emplace_back(Args&&... args) {
+			check(size() + 1);
+			return unchecked_emplace_back(std::forward<Args>(args)...);
+		}
+		//the unchecked versions only assert, for loops that already know the bound
+		constexpr void unchecked_push_back(const T& value) { unchecked_emplace_back(value); }
+		constexpr void unchecked_push_back(T&& value) { unchecked_emplace_back(std::move(value)); }
+		template<typename... Args>
+		constexpr reference unchecked_emplace_back(Args&&... args) {
+			assert(size() < N);
+			storage::construct(storage::count, std::forward<Args>(args)...);
+			return data()[storage::count++];
+		}
+		constexpr void pop_back() {
+			--storage::count;
+			storage::destroy(storage::count, storage::count + 1);
+		}
+		constexpr void clear() noexcept {
+			storage::destroy(0, storage::count);
+			storage::count = 0;
+		}
+		constexpr iterator insert(const_iterator pos, const T& value) { return emplace(pos, value); }
+		constexpr iterator insert(const_iterator pos, T&& value) { return emplace(pos, std::move(value)); }
+		template<typename... Args>
+		constexpr iterator emplace(const_iterator pos, Args&&... args);
+		constexpr iterator erase(const_iterator pos) { return erase(pos, pos + 1); }
+		constexpr iterator erase(const_iterator first, const_iterator last);
+		constexpr void resize(size_type n) { resize(n, T()); }
+		constexpr void resize(size_type n, const T& value);
+		void swap(static_vector& rhs) {
+			static_vector tmp(std::move(*this));
+			*this = std::move(rhs);
+			rhs = std::move(tmp);
+		}
+
+	private:
+		static constexpr void check(size_type n) {
+			if (n > N)
+				throw std::length_error("static_vector");
+		}
+	};
+
+	template<typename T, size_t N>
+	template<typename... Args>
+	constexpr typename static_vector<T, N>::iterator static_vector<T, N>::emplace(const_iterator pos, Args&&... args) {
+		check(size() + 1);
+		const size_type idx = pos - begin();
+		if (idx == size()) {
+			unchecked_emplace_back(std::forward<Args>(args)...);
+			return begin() + idx;
+		}
+		T value(std::forward<Args>(args)...);//the arguments may refer to an element
+		iterator p = data();
+		storage::construct(storage::count, std::move(p[storage::count - 1]));
+		for (size_type i = storage::count - 1; i > idx; --i)
+			p[i] = std::move(p[i - 1]);
+		p[idx] = std::move(value);
+		++storage::count;
+		return p + idx;
+	}
+
+	template<typename T, size_t N>
+	constexpr typename static_vector<T, N>::iterator static_vector<T, N>::erase(const_iterator first, const_iterator last) {
+		iterator p = data();
+		const size_type from = first - p;
+		const size_type n = last - first;
+		if (n) {
+			for (size_type i = from; i + n < size(); ++i)
+				p[i] = std::move(p[i + n]);
+			storage::destroy(size() - n, size());
+			storage::count -= n;
+		}
+		return p + from;
+	}
+
+	template<typename T, size_t N>
+	constexpr void static_vector<T, N>::resize(size_type n, const T& value) {
+		check(n);
+		if (n < size()) {
+			storage::destroy(n, size());
+			storage::count = n;
+		}
+		while (size() < n)
+			unchecked_push_back(value);
+	}
+
+
+	template<typename T, size_t N>
+	inline bool operator==(const static_vector<T, N>& lhs, const static_vector<T, N>& rhs) {
+		if (lhs.size() != rhs.size())
+			return false;
+		for (size_t i = 0; i < lhs.size(); ++i) {
+			if (!(lhs[i] == rhs[i]))
+				return false;
+		}
+		return true;
+	}
+	template<typename T, size_t N>
+	inline bool operator!=(const static_vector<T, N>& lhs, const static_vector<T, N>& rhs) {
+		return !(lhs == rhs);
+	}
+	template<typename T, size_t N>
+	inline void swap(static_vector<T, N>& lhs, static_vector<T, N>& rhs) {
+		lhs.swap(rhs);
+	}
+
+}
+
+#endif // !TINYSTL_STATIC_VECTOR_H
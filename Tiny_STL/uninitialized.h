@@ -0,0 +1,253 @@
+#pragma once
+#ifndef TINYSTL_UNINITIALIZED_H
+#define TINYSTL_UNINITIALIZED_H
+#include<cstddef>
+#include<cstring>
+#include<new>
+#include<type_traits>
+#include<utility>
+
+//construct and destroy ranges of objects on raw memory
+//trivial types take memcpy/memset, or nothing at all, instead of per-element loops
+
+namespace Tiny_STL {
+
+	template<class ForwardIterator>
+	using __iter_value_t = typename std::remove_cv<typename std::remove_reference<decltype(*std::declval<ForwardIterator&>())>::type>::type;
+
+	//destroy objects in [first, last)
+	template<class ForwardIterator>
+	inline void __destroy(ForwardIterator, ForwardIterator, std::true_type) { }
+
+	template<class ForwardIterator>
+	inline void __destroy(ForwardIterator first, ForwardIterator last, std::false_type)
+	{
+		typedef __iter_value_t<ForwardIterator> T;
+		for (; first != last; ++first)
+			(*first).~T();
+	}
+
+	template<class ForwardIterator>
+	inline void destroy(ForwardIterator first, ForwardIterator last)
+	{
+		Tiny_STL::__destroy(first, last,
+			std::is_trivially_destructible<__iter_value_t<ForwardIterator>>());
+	}
+
+
+	//copy [first, last) into the uninitialized memory starting at dest
+	//objects already built are destroyed if a constructor throws
+	template<class InputIterator, class ForwardIterator>
+	inline ForwardIterator __uninitialized_copy(InputIterator first, InputIterator last,
+		ForwardIterator dest, std::false_type)
+	{
+		typedef __iter_value_t<ForwardIterator> T;
+		ForwardIterator cur = dest;
+		try {
+			for (; first != last; ++first, ++cur)
+				new(static_cast<void *>(&*cur)) T(*first);
+		}
+		catch (...) {
+			Tiny_STL::destroy(dest, cur);
+			throw;
+		}
+		return cur;
+	}
+
+	template<class T>
+	inline T* __uninitialized_copy(const T* first, const T* last, T* dest, std::true_type)
+	{
+		size_t n = static_cast<size_t>(last - first);
+		if (n)
+			memmove(static_cast<void *>(dest), static_cast<const void *>(first), n * sizeof(T));
+		return dest + n;
+	}
+
+	//raw pointers to the same trivially copyable type are copied with memmove
+	template<class T>
+	inline T* uninitialized_copy(const T* first, const T* last, T* dest)
+	{
+		return Tiny_STL::__uninitialized_copy(first, last, dest, std::is_trivially_copyable<T>());
+	}
+
+	template<class T>
+	inline T* uninitialized_copy(T* first, T* last, T* dest)
+	{
+		return Tiny_STL::uninitialized_copy(static_cast<const T*>(first), static_cast<const T*>(last), dest);
+	}
+
+	template<class InputIterator, class ForwardIterator>
+	inline ForwardIterator uninitialized_copy(InputIterator first, InputIterator last, ForwardIterator dest)
+	{
+		return Tiny_STL::__uninitialized_copy(first, last, dest, std::false_type());
+	}
+
+
+	//move [first, last) into the uninitialized memory starting at dest
+	template<class InputIterator, class ForwardIterator>
+	inline ForwardIterator __uninitialized_move(InputIterator first, InputIterator last,
+		ForwardIterator dest, std::false_type)
+	{
+		typedef __iter_value_t<ForwardIterator> T;
+		ForwardIterator cur = dest;
+		try {
+			for (; first != last; ++first, ++cur)
+				new(static_cast<void *>(&*cur)) T(std::move(*first));
+		}
+		catch (...) {
+			Tiny_STL::destroy(dest, cur);
+			throw;
+		}
+		return cur;
+	}
+
+	//moving a trivially copyable object is a copy
+	template<class T>
+	inline T* __uninitialized_move(T* first, T* last, T* dest, std::true_type)
+	{
+		return Tiny_STL::__uninitialized_copy(static_cast<const T*>(first), static_cast<const T*>(last), dest,
+			std::true_type());
+	}
+
+	template<class T>
+	inline T* uninitialized_move(T* first, T* last, T* dest)
+	{
+		return Tiny_STL::__uninitialized_move(first, last, dest, std::is_trivially_copyable<T>());
+	}
+
+	template<class InputIterator, class ForwardIterator>
+	inline ForwardIterator uninitialized_move(InputIterator first, InputIterator last, ForwardIterator dest)
+	{
+		return Tiny_STL::__uninitialized_move(first, last, dest, std::false_type());
+	}
+
+
+	//construct n copies of value in the uninitialized memory starting at first
+	template<class ForwardIterator, class T>
+	inline ForwardIterator __uninitialized_fill_n(ForwardIterator first, size_t n, const T& value, std::false_type)
+	{
+		typedef __iter_value_t<ForwardIterator> V;
+		ForwardIterator cur = first;
+		try {
+			for (; n > 0; --n, ++cur)
+				new(static_cast<void *>(&*cur)) V(value);
+		}
+		catch (...) {
+			Tiny_STL::destroy(first, cur);
+			throw;
+		}
+		return cur;
+	}
+
+	//single-byte trivial types are filled with memset
+	template<class V, class T>
+	inline V* __uninitialized_fill_n(V* first, size_t n, const T& value, std::true_type)
+	{
+		V v = value;
+		unsigned char byte;
+		memcpy(&byte, &v, 1);
+		if (n)
+			memset(static_cast<void *>(first), byte, n);
+		return first + n;
+	}
+
+	template<class V, class T>
+	inline V* uninitialized_fill_n(V* first, size_t n, const T& value)
+	{
+		return Tiny_STL::__uninitialized_fill_n(first, n, value,
+			std::integral_constant<bool, sizeof(V) == 1 && std::is_trivially_copyable<V>::value>());
+	}
+
+	template<class ForwardIterator, class T>
+	inline ForwardIterator uninitialized_fill_n(ForwardIterator first, size_t n, const T& value)
+	{
+		return Tiny_STL::__uninitialized_fill_n(first, n, value, std::false_type());
+	}
+
+	template<class T>
+	inline void uninitialized_fill(T* first, T* last, const T& value)
+	{
+		Tiny_STL::uninitialized_fill_n(first, static_cast<size_t>(last - first), value);
+	}
+
+	template<class ForwardIterator, class T>
+	inline void uninitialized_fill(ForwardIterator first, ForwardIterator last, const T& value)
+	{
+		typedef __iter_value_t<ForwardIterator> V;
+		ForwardIterator cur = first;
+		try {
+			for (; cur != last; ++cur)
+				new(static_cast<void *>(&*cur)) V(value);
+		}
+		catch (...) {
+			Tiny_STL::destroy(first, cur);
+			throw;
+		}
+	}
+
+
+	//default-initialize objects in [first, last), a no-op for trivial types
+	template<class ForwardIterator>
+	inline void __uninitialized_default_construct(ForwardIterator, ForwardIterator, std::true_type) { }
+
+	template<class ForwardIterator>
+	inline void __uninitialized_default_construct(ForwardIterator first, ForwardIterator last, std::false_type)
+	{
+		typedef __iter_value_t<ForwardIterator> T;
+		ForwardIterator cur = first;
+		try {
+			for (; cur != last; ++cur)
+				new(static_cast<void *>(&*cur)) T;
+		}
+		catch (...) {
+			Tiny_STL::destroy(first, cur);
+			throw;
+		}
+	}
+
+	template<class ForwardIterator>
+	inline void uninitialized_default_construct(ForwardIterator first, ForwardIterator last)
+	{
+		Tiny_STL::__uninitialized_default_construct(first, last,
+			std::is_trivially_default_constructible<__iter_value_t<ForwardIterator>>());
+	}
+
+
+	//value-initialize objects in [first, last), scalars whose zero value is all-zero bits are zeroed with memset
+	//pointers to data members are left to the loop: their null value is -1 on the Itanium ABI
+	template<class T>
+	inline void __uninitialized_value_construct(T* first, T* last, std::true_type)
+	{
+		if (first != last)
+			memset(static_cast<void *>(first), 0, static_cast<size_t>(last - first) * sizeof(T));
+	}
+
+	template<class ForwardIterator>
+	inline void __uninitialized_value_construct(ForwardIterator first, ForwardIterator last, std::false_type)
+	{
+		typedef __iter_value_t<ForwardIterator> T;
+		ForwardIterator cur = first;
+		try {
+			for (; cur != last; ++cur)
+				new(static_cast<void *>(&*cur)) T();
+		}
+		catch (...) {
+			Tiny_STL::destroy(first, cur);
+			throw;
+		}
+	}
+
+	template<class T>
+	inline void uninitialized_value_construct(T* first, T* last)
+	{
+		Tiny_STL::__uninitialized_value_construct(first, last, std::integral_constant<bool,
+			std::is_arithmetic<T>::value || std::is_enum<T>::value || std::is_pointer<T>::value>());
+	}
+
+	template<class ForwardIterator>
+	inline void uninitialized_value_construct(ForwardIterator first, ForwardIterator last)
+	{
+		Tiny_STL::__uninitialized_value_construct(first, last, std::false_type());
+	}
+}
+#endif // !TINYSTL_UNINITIALIZED_H
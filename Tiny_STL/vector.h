@@ -1,15 +1,659 @@
 #pragma once
 #ifndef TINYSTL_VECTOR_H
 #define TINYSTL_VECTOR_H
-#include<iterator>
-#include<memory>
+#include"allocator.h"
+#include"uninitialized.h"
+#include"reverse_iterator.h"
+#include<algorithm>
+#include<cstddef>
+#include<cstring>
+#include<initializer_list>
+#include<stdexcept>
+#include<type_traits>
+#include<utility>
+
+//growth factor of vector in percent, a full vector grows to capacity() * TINYSTL_VECTOR_GROWTH / 100
+#ifndef TINYSTL_VECTOR_GROWTH
+#define TINYSTL_VECTOR_GROWTH 150
+#endif
 
 namespace Tiny_STL {
-	template<typename T,typename Alloc=allocator<T>>
-	class vector {
-		
+
+	//objects of such types can be moved to new storage by copying their bytes and forgetting the old ones
+	//specialize it for types like owning handles that are not trivially copyable but never point to themselves
+	template<typename T>
+	struct is_trivially_relocatable :public std::is_trivially_copyable<T> { };
+
+	//whether Alloc provides a static T* reallocate(T*, size_t old_n, size_t new_n) which keeps the contents
+	template<typename Alloc, typename T, typename = void>
+	struct __has_reallocate :public std::false_type { };
+
+	template<typename Alloc, typename T>
+	struct __has_reallocate<Alloc, T,
+		decltype(static_cast<void>(Alloc::reallocate(std::declval<T*>(), size_t(), size_t())))> :public std::true_type { };
+
+	//moving elements into new storage, shared by vector and small_vector
+	//transfer builds the elements in new storage, release ends the old ones
+	//trivially relocatable types take one memcpy and nothing to release
+	template<typename T>
+	struct __relocator {
+		typedef std::integral_constant<bool, is_trivially_relocatable<T>::value> relocate_tag;
+		//elements are moved when that cannot throw, otherwise copied (move_if_noexcept)
+		typedef std::integral_constant<bool,
+			std::is_nothrow_move_constructible<T>::value || !std::is_copy_constructible<T>::value> move_tag;
+
+		static void transfer(T* first, T* last, T* dest) {
+			transfer(first, last, dest, relocate_tag());
+		}
+		static void transfer(T* first, T* last, T* dest, std::true_type) {
+			if (first != last)
+				memcpy(static_cast<void *>(dest), static_cast<const void *>(first), (last - first) * sizeof(T));
+		}
+		static void transfer(T* first, T* last, T* dest, std::false_type) {
+			transfer_elements(first, last, dest, move_tag());
+		}
+		static void transfer_elements(T* first, T* last, T* dest, std::true_type) {
+			Tiny_STL::uninitialized_move(first, last, dest);
+		}
+		static void transfer_elements(T* first, T* last, T* dest, std::false_type) {
+			Tiny_STL::uninitialized_copy(first, last, dest);
+		}
+		static void release(T* first, T* last) {
+			release(first, last, relocate_tag());
+		}
+		static void release(T*, T*, std::true_type) { }
+		static void release(T* first, T* last, std::false_type) {
+			Tiny_STL::destroy(first, last);
+		}
+	};
+
+
+	//everything vector and small_vector share: the elements live in [start, finish) of a buffer ending at end_of_storage
+	//Derived only decides where a buffer comes from and whether it goes back to Alloc,
+	//through heap_allocated(p), which tells whether the buffer at p was obtained from Alloc
+	//Derived constructors delegate to one that sets up the pointers, so its destructor runs if they throw
+	template<typename T, typename Alloc, typename Derived>
+	class __vector_base {
+		static_assert(TINYSTL_VECTOR_GROWTH > 100, "TINYSTL_VECTOR_GROWTH must be greater than 100");
+	public:
+		typedef T										value_type;
+		typedef T*										pointer;
+		typedef const T*								const_pointer;
+		typedef T&										reference;
+		typedef const T&								const_reference;
+		typedef size_t									size_type;
+		typedef ptrdiff_t								difference_type;
+		typedef T*										iterator;
+		typedef const T*								const_iterator;
+		typedef Tiny_STL::reverse_iterator<iterator>		reverse_iterator;
+		typedef Tiny_STL::reverse_iterator<const_iterator>	const_reverse_iterator;
+		typedef Alloc									allocator_type;
+
+	protected:
+		typedef Alloc data_allocator;
+		//growth goes through Alloc::reallocate, which may extend the block in place, when bytes can be copied
+		typedef std::integral_constant<bool,
+			__has_reallocate<Alloc, T>::value && std::is_trivially_copyable<T>::value> realloc_tag;
+		typedef __relocator<T> relocator;
+
+		iterator start;
+		iterator finish;
+		iterator end_of_storage;
+
+		__vector_base(iterator first, iterator last, iterator storage_end) noexcept
+			:start(first), finish(last), end_of_storage(storage_end) { }
+		__vector_base(const __vector_base&) = default;
+		__vector_base& operator=(const __vector_base&) = default;
+		~__vector_base() = default;
+
+	public:
+		void assign(size_type n, const T& value);
+		template<typename InputIterator,
+			typename = typename std::enable_if<!std::is_integral<InputIterator>::value>::type>
+		void assign(InputIterator first, InputIterator last) {
+			range_assign(first, last, Tiny_STL::__category(first));
+		}
+		void assign(std::initializer_list<T> il) { assign(il.begin(), il.end()); }
+
+		//element access
+		reference at(size_type n) {
+			if (n >= size())
+				throw std::out_of_range("vector::at");
+			return start[n];
+		}
+		const_reference at(size_type n) const {
+			if (n >= size())
+				throw std::out_of_range("vector::at");
+			return start[n];
+		}
+		reference operator[](size_type n) { return start[n]; }
+		const_reference operator[](size_type n) const { return start[n]; }
+		reference front() { return *start; }
+		const_reference front() const { return *start; }
+		reference back() { return *(finish - 1); }
+		const_reference back() const { return *(finish - 1); }
+		pointer data() noexcept { return start; }
+		const_pointer data() const noexcept { return start; }
+
+		//iterators
+		iterator begin() noexcept { return start; }
+		const_iterator begin() const noexcept { return start; }
+		const_iterator cbegin() const noexcept { return start; }
+		iterator end() noexcept { return finish; }
+		const_iterator end() const noexcept { return finish; }
+		const_iterator cend() const noexcept { return finish; }
+		reverse_iterator rbegin() noexcept { return reverse_iterator(finish); }
+		const_reverse_iterator rbegin() const noexcept { return const_reverse_iterator(finish); }
+		const_reverse_iterator crbegin() const noexcept { return const_reverse_iterator(finish); }
+		reverse_iterator rend() noexcept { return reverse_iterator(start); }
+		const_reverse_iterator rend() const noexcept { return const_reverse_iterator(start); }
+		const_reverse_iterator crend() const noexcept { return const_reverse_iterator(start); }
+
+		//capacity
+		bool empty() const noexcept { return start == finish; }
+		size_type size() const noexcept { return static_cast<size_type>(finish - start); }
+		size_type max_size() const noexcept { return static_cast<size_type>(-1) / sizeof(T); }
+		size_type capacity() const noexcept { return static_cast<size_type>(end_of_storage - start); }
+		void reserve(size_type n);
+
+		//modifiers
+		void clear() noexcept {
+			Tiny_STL::destroy(start, finish);
+			finish = start;
+		}
+		iterator insert(const_iterator pos, const T& value) { return emplace(pos, value); }
+		iterator insert(const_iterator pos, T&& value) { return emplace(pos, std::move(value)); }
+		iterator insert(const_iterator pos, size_type n, const T& value);
+		template<typename InputIterator,
+			typename = typename std::enable_if<!std::is_integral<InputIterator>::value>::type>
+		iterator insert(const_iterator pos, InputIterator first, InputIterator last) {
+			return range_insert(pos - start, first, last, Tiny_STL::__category(first));
+		}
+		iterator insert(const_iterator pos, std::initializer_list<T> il) {
+			return insert(pos, il.begin(), il.end());
+		}
+		template<typename... Args>
+		iterator emplace(const_iterator pos, Args&&... args);
+		iterator erase(const_iterator pos) { return erase(pos, pos + 1); }
+		iterator erase(const_iterator first, const_iterator last);
+		void push_back(const T& value) { emplace_back(value); }
+		void push_back(T&& value) { emplace_back(std::move(value)); }
+		template<typename... Args>
+		reference emplace_back(Args&&... args) {
+			if (finish != end_of_storage) {
+				data_allocator::construct(finish, std::forward<Args>(args)...);
+				++finish;
+			}
+			else {
+				emplace_back_aux(realloc_tag(), std::forward<Args>(args)...);
+			}
+			return *(finish - 1);
+		}
+		void pop_back() {
+			--finish;
+			data_allocator::destroy(finish);
+		}
+		void resize(size_type n);
+		void resize(size_type n, const T& value);
+
+	protected:
+		bool heap_allocated() const noexcept { return static_cast<const Derived*>(this)->heap_allocated(start); }
+		//give a buffer back to Alloc, unless Derived owns it
+		void free_storage(iterator p, size_type cap) {
+			if (static_cast<const Derived*>(this)->heap_allocated(p))
+				data_allocator::deallocate(p, cap);
+		}
+		void release_storage() {
+			Tiny_STL::destroy(start, finish);
+			free_storage(start, capacity());
+		}
+		//capacity for at least n elements: grow geometrically, but never less than n
+		size_type next_capacity(size_type n) const;
+		//move the elements into storage for new_cap elements
+		void reallocate_storage(size_type new_cap);
+		void reallocate_storage(size_type new_cap, std::true_type);
+		void reallocate_storage(size_type new_cap, std::false_type);
+		//replace the contents by n elements built into fresh storage with fill(pointer)
+		//the old elements stay untouched if fill throws, and may be its source
+		template<typename Fill>
+		void replace_storage(size_type n, Fill fill);
+		//grow and construct a gap of n elements at index idx with construct_gap(pointer)
+		//the old elements stay untouched if anything throws
+		template<typename Construct>
+		iterator realloc_insert(size_type idx, size_type n, Construct construct_gap);
+		template<typename... Args>
+		void emplace_back_aux(std::true_type, Args&&... args);
+		template<typename... Args>
+		void emplace_back_aux(std::false_type, Args&&... args);
+		template<typename InputIterator>
+		void append_range(InputIterator first, InputIterator last);
+		//ranges that can be walked twice are measured once and built with a single allocation
+		//input ranges fall back to amortized growth
+		template<typename InputIterator>
+		void range_assign(InputIterator first, InputIterator last, input_iterator_tag);
+		template<typename ForwardIterator>
+		void range_assign(ForwardIterator first, ForwardIterator last, forward_iterator_tag);
+		template<typename InputIterator>
+		iterator range_insert(size_type idx, InputIterator first, InputIterator last, input_iterator_tag);
+		template<typename ForwardIterator>
+		iterator range_insert(size_type idx, ForwardIterator first, ForwardIterator last, forward_iterator_tag);
+	};
+
+
+	template<typename T, typename Alloc, typename Derived>
+	void __vector_base<T, Alloc, Derived>::assign(size_type n, const T& value) {
+		if (n > capacity()) {
+			replace_storage(n, [&](iterator p) {
+				Tiny_STL::uninitialized_fill_n(p, n, value);
+			});
+		}
+		else if (n > size()) {
+			std::fill(start, finish, value);
+			finish = Tiny_STL::uninitialized_fill_n(finish, n - size(), value);
+		}
+		else {
+			erase(std::fill_n(start, n, value), finish);
+		}
+	}
+
+	template<typename T, typename Alloc, typename Derived>
+	template<typename InputIterator>
+	void __vector_base<T, Alloc, Derived>::range_assign(InputIterator first, InputIterator last, input_iterator_tag) {
+		iterator cur = start;
+		for (; first != last && cur != finish; ++first, ++cur)
+			*cur = *first;
+		if (first == last)
+			erase(cur, finish);
+		else
+			append_range(first, last);
+	}
+
+	template<typename T, typename Alloc, typename Derived>
+	template<typename ForwardIterator>
+	void __vector_base<T, Alloc, Derived>::range_assign(ForwardIterator first, ForwardIterator last, forward_iterator_tag) {
+		const size_type n = static_cast<size_type>(Tiny_STL::distance(first, last));
+		if (n > capacity()) {
+			replace_storage(n, [&](iterator p) {
+				Tiny_STL::uninitialized_copy(first, last, p);
+			});
+		}
+		else if (n <= size()) {
+			erase(std::copy(first, last, start), finish);
+		}
+		else {
+			ForwardIterator mid = first;
+			Tiny_STL::advance(mid, size());
+			std::copy(first, mid, start);
+			finish = Tiny_STL::uninitialized_copy(mid, last, finish);
+		}
+	}
+
+	template<typename T, typename Alloc, typename Derived>
+	inline typename __vector_base<T, Alloc, Derived>::size_type __vector_base<T, Alloc, Derived>::next_capacity(size_type n) const {
+		if (n > max_size())
+			throw std::length_error("vector");
+		const size_type cap = capacity();
+		size_type grown = cap < static_cast<size_type>(-1) / TINYSTL_VECTOR_GROWTH ?
+			cap * TINYSTL_VECTOR_GROWTH / 100 : max_size();
+		if (grown > max_size())
+			grown = max_size();
+		if (grown <= cap)//very small capacities would not grow at all
+			grown = cap + 1;
+		return grown < n ? n : grown;
+	}
+
+	template<typename T, typename Alloc, typename Derived>
+	inline void __vector_base<T, Alloc, Derived>::reallocate_storage(size_type new_cap) {
+		reallocate_storage(new_cap, realloc_tag());
+	}
+	//the allocator copies the bytes itself, and may not have to move them at all
+	//a buffer that did not come from Alloc cannot be handed to it
+	template<typename T, typename Alloc, typename Derived>
+	void __vector_base<T, Alloc, Derived>::reallocate_storage(size_type new_cap, std::true_type) {
+		if (!heap_allocated()) {
+			reallocate_storage(new_cap, std::false_type());
+			return;
+		}
+		const size_type n = size();
+		start = data_allocator::reallocate(start, capacity(), new_cap);
+		finish = start + n;
+		end_of_storage = start + new_cap;
+	}
+	template<typename T, typename Alloc, typename Derived>
+	void __vector_base<T, Alloc, Derived>::reallocate_storage(size_type new_cap, std::false_type) {
+		const size_type n = size();
+		iterator new_start = data_allocator::allocate(new_cap);
+		try {
+			relocator::transfer(start, finish, new_start);
+		}
+		catch (...) {
+			data_allocator::deallocate(new_start, new_cap);
+			throw;
+		}
+		relocator::release(start, finish);
+		free_storage(start, capacity());
+		start = new_start;
+		finish = new_start + n;
+		end_of_storage = new_start + new_cap;
+	}
+
+	template<typename T, typename Alloc, typename Derived>
+	template<typename Fill>
+	void __vector_base<T, Alloc, Derived>::replace_storage(size_type n, Fill fill) {
+		if (n > max_size())
+			throw std::length_error("vector");
+		iterator new_start = data_allocator::allocate(n);
+		try {
+			fill(new_start);
+		}
+		catch (...) {
+			data_allocator::deallocate(new_start, n);
+			throw;
+		}
+		release_storage();
+		start = new_start;
+		finish = end_of_storage = new_start + n;
+	}
+
+	template<typename T, typename Alloc, typename Derived>
+	template<typename Construct>
+	typename __vector_base<T, Alloc, Derived>::iterator __vector_base<T, Alloc, Derived>::realloc_insert(size_type idx, size_type n, Construct construct_gap) {
+		const size_type old_size = size();
+		const size_type new_cap = next_capacity(old_size + n);
+		iterator new_start = data_allocator::allocate(new_cap);
+		iterator gap = new_start + idx;
+		try {
+			construct_gap(gap);
+		}
+		catch (...) {
+			data_allocator::deallocate(new_start, new_cap);
+			throw;
+		}
+		//only the copying transfer can throw, and it leaves the old elements intact
+		try {
+			relocator::transfer(start, start + idx, new_start);
+			try {
+				relocator::transfer(start + idx, finish, gap + n);
+			}
+			catch (...) {
+				Tiny_STL::destroy(new_start, gap);
+				throw;
+			}
+		}
+		catch (...) {
+			Tiny_STL::destroy(gap, gap + n);
+			data_allocator::deallocate(new_start, new_cap);
+			throw;
+		}
+		relocator::release(start, finish);
+		free_storage(start, capacity());
+		start = new_start;
+		finish = new_start + old_size + n;
+		end_of_storage = new_start + new_cap;
+		return gap;
+	}
+
+	//the arguments may refer to an element, so the new one is built before the storage moves
+	template<typename T, typename Alloc, typename Derived>
+	template<typename... Args>
+	void __vector_base<T, Alloc, Derived>::emplace_back_aux(std::true_type, Args&&... args) {
+		T value(std::forward<Args>(args)...);
+		reallocate_storage(next_capacity(size() + 1));
+		data_allocator::construct(finish, std::move(value));
+		++finish;
+	}
+	template<typename T, typename Alloc, typename Derived>
+	template<typename... Args>
+	void __vector_base<T, Alloc, Derived>::emplace_back_aux(std::false_type, Args&&... args) {
+		realloc_insert(size(), 1, [&](iterator gap) {
+			data_allocator::construct(gap, std::forward<Args>(args)...);
+		});
+	}
+
+	template<typename T, typename Alloc, typename Derived>
+	template<typename InputIterator>
+	void __vector_base<T, Alloc, Derived>::append_range(InputIterator first, InputIterator last) {
+		for (; first != last; ++first)
+			emplace_back(*first);
+	}
+
+	template<typename T, typename Alloc, typename Derived>
+	void __vector_base<T, Alloc, Derived>::reserve(size_type n) {
+		if (n <= capacity())
+			return;
+		if (n > max_size())
+			throw std::length_error("vector::reserve");
+		reallocate_storage(n);
+	}
+
+	template<typename T, typename Alloc, typename Derived>
+	template<typename... Args>
+	typename __vector_base<T, Alloc, Derived>::iterator __vector_base<T, Alloc, Derived>::emplace(const_iterator pos, Args&&... args) {
+		const size_type idx = pos - start;
+		if (finish == end_of_storage) {
+			return realloc_insert(idx, 1, [&](iterator gap) {
+				data_allocator::construct(gap, std::forward<Args>(args)...);
+			});
+		}
+		if (start + idx == finish) {
+			data_allocator::construct(finish, std::forward<Args>(args)...);
+			++finish;
+			return start + idx;
+		}
+		T value(std::forward<Args>(args)...);
+		data_allocator::construct(finish, std::move(*(finish - 1)));
+		++finish;
+		std::move_backward(start + idx, finish - 2, finish - 1);
+		start[idx] = std::move(value);
+		return start + idx;
+	}
+
+	template<typename T, typename Alloc, typename Derived>
+	typename __vector_base<T, Alloc, Derived>::iterator __vector_base<T, Alloc, Derived>::insert(const_iterator pos, size_type n, const T& value) {
+		const size_type idx = pos - start;
+		if (n == 0)
+			return start + idx;
+		if (size_type(end_of_storage - finish) < n) {
+			return realloc_insert(idx, n, [&](iterator gap) {
+				Tiny_STL::uninitialized_fill_n(gap, n, value);
+			});
+		}
+		const T copy(value);
+		iterator position = start + idx;
+		const size_type elems_after = finish - position;
+		iterator old_finish = finish;
+		if (elems_after > n) {
+			Tiny_STL::uninitialized_move(finish - n, finish, finish);
+			finish += n;
+			std::move_backward(position, old_finish - n, old_finish);
+			std::fill(position, position + n, copy);
+		}
+		else {
+			finish = Tiny_STL::uninitialized_fill_n(finish, n - elems_after, copy);
+			Tiny_STL::uninitialized_move(position, old_finish, finish);
+			finish += elems_after;
+			std::fill(position, old_finish, copy);
+		}
+		return position;
+	}
+
+	//input iterators can only be walked once: append at the end, then rotate into place
+	template<typename T, typename Alloc, typename Derived>
+	template<typename InputIterator>
+	typename __vector_base<T, Alloc, Derived>::iterator __vector_base<T, Alloc, Derived>::range_insert(size_type idx, InputIterator first, InputIterator last, input_iterator_tag) {
+		const size_type old_size = size();
+		append_range(first, last);
+		std::rotate(start + idx, start + old_size, finish);
+		return start + idx;
+	}
+
+	//the range must not point into the container, as with insert(pos, n, value) the tail is shifted once
+	template<typename T, typename Alloc, typename Derived>
+	template<typename ForwardIterator>
+	typename __vector_base<T, Alloc, Derived>::iterator __vector_base<T, Alloc, Derived>::range_insert(size_type idx, ForwardIterator first, ForwardIterator last, forward_iterator_tag) {
+		const size_type n = static_cast<size_type>(Tiny_STL::distance(first, last));
+		if (n == 0)
+			return start + idx;
+		if (size_type(end_of_storage - finish) < n) {
+			return realloc_insert(idx, n, [&](iterator gap) {
+				Tiny_STL::uninitialized_copy(first, last, gap);
+			});
+		}
+		iterator position = start + idx;
+		const size_type elems_after = finish - position;
+		iterator old_finish = finish;
+		if (elems_after > n) {
+			Tiny_STL::uninitialized_move(finish - n, finish, finish);
+			finish += n;
+			std::move_backward(position, old_finish - n, old_finish);
+			std::copy(first, last, position);
+		}
+		else {
+			ForwardIterator mid = first;
+			Tiny_STL::advance(mid, elems_after);
+			finish = Tiny_STL::uninitialized_copy(mid, last, finish);
+			Tiny_STL::uninitialized_move(position, old_finish, finish);
+			finish += elems_after;
+			std::copy(first, mid, position);
+		}
+		return position;
+	}
+
+	template<typename T, typename Alloc, typename Derived>
+	typename __vector_base<T, Alloc, Derived>::iterator __vector_base<T, Alloc, Derived>::erase(const_iterator first, const_iterator last) {
+		iterator position = start + (first - start);
+		if (first != last) {
+			iterator new_finish = std::move(position + (last - first), finish, position);
+			Tiny_STL::destroy(new_finish, finish);
+			finish = new_finish;
+		}
+		return position;
+	}
+
+	template<typename T, typename Alloc, typename Derived>
+	void __vector_base<T, Alloc, Derived>::resize(size_type n) {
+		if (n <= size()) {
+			erase(start + n, finish);
+			return;
+		}
+		//grow geometrically like insert, so that repeated resize(size() + 1) stays amortized
+		if (n > capacity())
+			reallocate_storage(next_capacity(n));
+		Tiny_STL::uninitialized_value_construct(finish, start + n);
+		finish = start + n;
+	}
+
+	template<typename T, typename Alloc, typename Derived>
+	void __vector_base<T, Alloc, Derived>::resize(size_type n, const T& value) {
+		if (n <= size())
+			erase(start + n, finish);
+		else
+			insert(finish, n - size(), value);
+	}
+
+	template<typename T, typename Alloc, typename Derived>
+	inline bool operator==(const __vector_base<T, Alloc, Derived>& lhs, const __vector_base<T, Alloc, Derived>& rhs) {
+		return lhs.size() == rhs.size() && std::equal(lhs.begin(), lhs.end(), rhs.begin());
+	}
+	template<typename T, typename Alloc, typename Derived>
+	inline bool operator!=(const __vector_base<T, Alloc, Derived>& lhs, const __vector_base<T, Alloc, Derived>& rhs) {
+		return !(lhs == rhs);
+	}
+	template<typename T, typename Alloc, typename Derived>
+	inline bool operator<(const __vector_base<T, Alloc, Derived>& lhs, const __vector_base<T, Alloc, Derived>& rhs) {
+		return std::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+	}
+	template<typename T, typename Alloc, typename Derived>
+	inline bool operator>(const __vector_base<T, Alloc, Derived>& lhs, const __vector_base<T, Alloc, Derived>& rhs) {
+		return rhs < lhs;
+	}
+	template<typename T, typename Alloc, typename Derived>
+	inline bool operator<=(const __vector_base<T, Alloc, Derived>& lhs, const __vector_base<T, Alloc, Derived>& rhs) {
+		return !(rhs < lhs);
+	}
+	template<typename T, typename Alloc, typename Derived>
+	inline bool operator>=(const __vector_base<T, Alloc, Derived>& lhs, const __vector_base<T, Alloc, Derived>& rhs) {
+		return !(lhs < rhs);
+	}
+
+
+	//every buffer of vector comes from Alloc, an empty vector holds none
+	template<typename T, typename Alloc = allocator<T>>
+	class vector :public __vector_base<T, Alloc, vector<T, Alloc>> {
+		typedef __vector_base<T, Alloc, vector<T, Alloc>> base;
+		friend base;
+	public:
+		typedef typename base::size_type		size_type;
+		typedef typename base::iterator			iterator;
+		typedef typename base::const_iterator	const_iterator;
+
+	public:
+		//constructors
+		vector() noexcept :base(nullptr, nullptr, nullptr) { }
+		explicit vector(size_type n) :vector() { this->resize(n); }
+		vector(size_type n, const T& value) :vector() { this->assign(n, value); }
+		template<typename InputIterator,
+			typename = typename std::enable_if<!std::is_integral<InputIterator>::value>::type>
+		vector(InputIterator first, InputIterator last) :vector() { this->assign(first, last); }
+		vector(std::initializer_list<T> il) :vector() { this->assign(il.begin(), il.end()); }
+		vector(const vector& rhs) :vector() { this->assign(rhs.begin(), rhs.end()); }
+		vector(vector&& rhs) noexcept :base(rhs.start, rhs.finish, rhs.end_of_storage) {
+			rhs.start = rhs.finish = rhs.end_of_storage = nullptr;
+		}
+		~vector() { this->release_storage(); }
+
+		vector& operator=(const vector& rhs) {
+			if (this != &rhs)
+				this->assign(rhs.begin(), rhs.end());
+			return *this;
+		}
+		vector& operator=(vector&& rhs) noexcept;
+		vector& operator=(std::initializer_list<T> il) {
+			this->assign(il.begin(), il.end());
+			return *this;
+		}
+
+		void shrink_to_fit();
+		void swap(vector& rhs) noexcept {
+			std::swap(this->start, rhs.start);
+			std::swap(this->finish, rhs.finish);
+			std::swap(this->end_of_storage, rhs.end_of_storage);
+		}
+
+	private:
+		bool heap_allocated(const T*) const noexcept { return true; }
 	};
 
+
+	template<typename T, typename Alloc>
+	vector<T, Alloc>& vector<T, Alloc>::operator=(vector&& rhs) noexcept {
+		if (this != &rhs) {
+			this->release_storage();
+			this->start = rhs.start;
+			this->finish = rhs.finish;
+			this->end_of_storage = rhs.end_of_storage;
+			rhs.start = rhs.finish = rhs.end_of_storage = nullptr;
+		}
+		return *this;
+	}
+
+	template<typename T, typename Alloc>
+	void vector<T, Alloc>::shrink_to_fit() {
+		if (this->finish == this->end_of_storage)
+			return;
+		if (this->empty()) {
+			this->free_storage(this->start, this->capacity());
+			this->start = this->finish = this->end_of_storage = nullptr;
+			return;
+		}
+		this->reallocate_storage(this->size());
+	}
+
+	template<typename T, typename Alloc>
+	inline void swap(vector<T, Alloc>& lhs, vector<T, Alloc>& rhs) noexcept {
+		lhs.swap(rhs);
+	}
+
 }
 
 #endif // !TINYSTL_VECTOR_H